@@ -1,5 +1,9 @@
 #include "matrix.h"
+#include "cpu_dispatch.h"
 #include <iostream>
+#ifdef CPU_DISPATCH
+#include <immintrin.h>
+#endif
 
 void BringError(double dif)
 {
@@ -29,4 +33,68 @@ double Get(const CMatrix<1, 1>& M)
 
 CMatrix<1, 1> Mat11( double x ) { return CMatrix<1, 1>( x ); }
 
-long long nMatrices = 0;
\ No newline at end of file
+long long nMatrices = 0;
+
+namespace
+{
+	constexpr size_t DOT_LANES = 8; // Partial sums, lane k takes the products with index k mod 8
+
+	double SumLanes( const double* pSums )
+	{
+		return ((pSums[0] + pSums[4]) + (pSums[2] + pSums[6])) + ((pSums[1] + pSums[5]) + (pSums[3] + pSums[7]));
+	}
+	double DotProductPortable( const double* pX, const double* pY, size_t N )
+	{
+		double Sums[DOT_LANES] = {};
+		size_t i = 0;
+		for ( ; i + DOT_LANES <= N; i += DOT_LANES )
+			for ( size_t k = 0; k < DOT_LANES; ++k )
+				Sums[k] += pX[i+k] * pY[i+k];
+		for ( size_t k = 0; i < N; ++i, ++k )
+			Sums[k] += pX[i] * pY[i];
+		return SumLanes( Sums );
+	}
+#ifdef CPU_DISPATCH
+	CPU_TARGET( "sse2" ) double DotProductSSE2( const double* pX, const double* pY, size_t N )
+	{
+		__m128d Sums[4] = { _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd() };
+		size_t i = 0;
+		for ( ; i + DOT_LANES <= N; i += DOT_LANES )
+			for ( size_t k = 0; k < 4; ++k )
+				Sums[k] = _mm_add_pd( Sums[k], _mm_mul_pd( _mm_loadu_pd( pX + i + 2*k ), _mm_loadu_pd( pY + i + 2*k ) ) );
+		double Lanes[DOT_LANES];
+		for ( size_t k = 0; k < 4; ++k )
+			_mm_storeu_pd( Lanes + 2*k, Sums[k] );
+		for ( size_t k = 0; i < N; ++i, ++k )
+			Lanes[k] += pX[i] * pY[i];
+		return SumLanes( Lanes );
+	}
+	CPU_TARGET( "avx2" ) double DotProductAVX2( const double* pX, const double* pY, size_t N )
+	{
+		__m256d Sums[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+		size_t i = 0;
+		for ( ; i + DOT_LANES <= N; i += DOT_LANES )
+			for ( size_t k = 0; k < 2; ++k )
+				Sums[k] = _mm256_add_pd( Sums[k], _mm256_mul_pd( _mm256_loadu_pd( pX + i + 4*k ), _mm256_loadu_pd( pY + i + 4*k ) ) );
+		double Lanes[DOT_LANES];
+		for ( size_t k = 0; k < 2; ++k )
+			_mm256_storeu_pd( Lanes + 4*k, Sums[k] );
+		for ( size_t k = 0; i < N; ++i, ++k )
+			Lanes[k] += pX[i] * pY[i];
+		return SumLanes( Lanes );
+	}
+#endif
+}
+
+double DotProduct( const double* pX, const double* pY, size_t N )
+{
+	switch ( GetKernelLevel( KERNEL_DOT_PRODUCT ) )
+	{
+#ifdef CPU_DISPATCH
+	case CPU_AVX512: // AVX-512 turns on FMA in g++, fused multiply-adds would round differently
+	case CPU_AVX2: return DotProductAVX2( pX, pY, N );
+	case CPU_SSE2: return DotProductSSE2( pX, pY, N );
+#endif
+	default: return DotProductPortable( pX, pY, N );
+	}
+}
@@ -50,6 +50,9 @@ typename SConditionalMatrixMultiplication<
 template<size_t N>
 using SIZET = std::integral_constant<size_t, N>;
 
+double DotProduct( const double* pX, const double* pY, size_t N ); // Vectorized for the CPU (cpu_dispatch.h). Every variant adds in the same order
+constexpr size_t DOT_PRODUCT_MIN_SIZE = 16; // Shorter rows stay inline loops
+
 namespace NMatrix
 {
 	template<bool B>
@@ -177,8 +180,13 @@ CMatrix<N, P> CMatrix<N,M>::operator*(const CMatrix<M, P>& Other) const
 		const auto OtherRow = std::move(Other.GetTranspose()._data[0]);
 		for ( int n = 0; n < N; ++n )
 		{
-			double vRetElement = 0.0;
 			const auto& MyRow = _data[n];
+			if ( M >= DOT_PRODUCT_MIN_SIZE )
+			{
+				Ret[n][0] = DotProduct( MyRow.data(), OtherRow.data(), M );
+				continue;
+			}
+			double vRetElement = 0.0;
 			for ( int m = 0; m < M; ++m )
 			{
 				vRetElement += MyRow[m] * OtherRow[m];
@@ -212,6 +220,11 @@ std::array<double, N> CMatrix<N, M>::operator*( const std::array<double,M>& X )
 	{
 		const auto& MyRow = _data[n];
 		double& vRet = Ret[n];
+		if ( M >= DOT_PRODUCT_MIN_SIZE )
+		{
+			vRet = DotProduct( MyRow.data(), X.data(), M );
+			continue;
+		}
 		for ( int m = 0; m < M; ++m )
 		{
 			vRet += MyRow[m] * X[m];
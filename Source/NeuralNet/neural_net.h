@@ -51,6 +51,7 @@ struct SNeuralNetwork<TInputGenerator> // 'Layer 0'
 	typedef decltype(FieldRepresentation( NewField(), 1 )) TOut;
 	TOut TOutDummy() const { return TOut(); }
 	constexpr static size_t NOut = TInputGenerator::SIZE;
+	constexpr static int LOOKAHEAD = TInputGenerator::LOOKAHEAD; // Generations the input steps past the field
 };
 template<typename WType, typename Activation, typename... Ts>
 struct SNeuralNetwork<WType, Activation, Ts...>
@@ -71,6 +72,7 @@ struct SNeuralNetwork<WType, Activation, Ts...>
 	SNeuralNetwork<Ts...> _Prev;
 	constexpr static size_t In = decltype(_Prev)::NOut;
 	constexpr static size_t _N = decltype(_Prev)::_N+1;
+	constexpr static int LOOKAHEAD = decltype(_Prev)::LOOKAHEAD;
 	using MatrixType = SMatrixType<WType, decltype(_Prev.TOutDummy()), In>;
 	decltype(MatrixType::Create()) _W = MatrixType::Create();
 	constexpr static size_t NOut = decltype(_W)::_N;
@@ -219,13 +221,13 @@ struct SBackwardProp<TNeuralNet, MAX_N, MAX_N>
 	AutoVar( _E_X, _E_Z * _Z_X ); // For each j, ROW
 };
 
-template<size_t OUT_DEPTH, size_t RADIUS>
+template<size_t OUT_DEPTH, size_t RADIUS, typename TGeometry = SDefaultGeometry>
 struct SCreateConv
 {
 	template<typename TPropagationData> // Input type
 	static auto Create()
 	{
-		return TPropagationData::CreateConvLayer( SIZET<OUT_DEPTH>(), RADIUS );
+		return TPropagationData::template CreateConvLayer<OUT_DEPTH, TGeometry>( SIZET<OUT_DEPTH>(), RADIUS );
 	}
 };
 struct SCreateInternalizer
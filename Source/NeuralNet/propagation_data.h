@@ -39,7 +39,7 @@ public:
 	double GetData( size_t depth, size_t position ) const { return _data[depth*_SizePerDepth+position]; }
 	double GetExtra( size_t i ) const { return _data[_Depth*_SizePerDepth+i]; }
 
-	template<size_t OUT_DEPTH>
+	template<size_t OUT_DEPTH, typename TGeometry = SDefaultGeometry>
 	static CConvolutionMatrix<
 		CPropagationData<OUT_DEPTH, SIZE_PER_DEPTH, EXTRA_SINGLES>,
 		CPropagationData<DEPTH, SIZE_PER_DEPTH, EXTRA_SINGLES>
@@ -81,12 +81,14 @@ auto GetTranspose( const CPropagationData<DEPTH,SIZE_PER_DEPTH,EXTRA_SINGLES>& X
 }
 
 template<size_t IN_DEPTH, size_t SIZE_PER_DEPTH, size_t EXTRA_SINGLES>
-template<size_t OUT_DEPTH>
+template<size_t OUT_DEPTH, typename TGeometry>
 CConvolutionMatrix<
 	CPropagationData<OUT_DEPTH, SIZE_PER_DEPTH, EXTRA_SINGLES>,
 	CPropagationData<IN_DEPTH, SIZE_PER_DEPTH, EXTRA_SINGLES>
 > CPropagationData<IN_DEPTH, SIZE_PER_DEPTH, EXTRA_SINGLES>::CreateConvLayer( SIZET<OUT_DEPTH> Dummy1, int nRadius )
 {
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
 	static_assert(SIZE_PER_DEPTH >= WIDTH*HEIGHT, "CPropagationData only meant for (modified) field representations");
 	CConvolutionMatrix<
 		CPropagationData<OUT_DEPTH, SIZE_PER_DEPTH, EXTRA_SINGLES>,
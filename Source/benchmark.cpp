@@ -0,0 +1,509 @@
+#include "benchmark.h"
+#include "game_field.h"
+#include "packed_field.h"
+#include "move.h"
+#include "bot.h"
+#include "rollout.h"
+#include "cpu_dispatch.h"
+#include "cluster.h"
+#include "util.h"
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	using TClock = std::chrono::high_resolution_clock;
+	unsigned long long s_nChecksum = 0; // Keeps the optimizer from skipping the work
+
+	template<typename TGeometry, typename TRandom>
+	TGameField<TGeometry> RandomField( TRandom& Random, int nPerMille ) // Every square alive with nPerMille/1000, either colour
+	{
+		TGameField<TGeometry> Ret;
+		for ( int row = 0; row < TGeometry::HEIGHT; ++row ) for ( int col = 0; col < TGeometry::WIDTH; ++col )
+		{
+			if ( int( Random() % 1000 ) < nPerMille )
+				Ret.SetSquare( row, col, Random() % 2 ? GOOD : BAD );
+		}
+		Ret._player_to_move = Random() % 2 ? 1 : -1;
+		Ret._time = short( Random() % MAX_ROUNDS );
+		return Ret;
+	}
+	template<typename TGeometry, typename TRandom>
+	TGameField<TGeometry> NearEmptyField( TRandom& Random )
+	{
+		TGameField<TGeometry> Ret;
+		const int nLives = 1 + Random() % 6;
+		for ( int i = 0; i < nLives; ++i )
+		{
+			const FieldSquare Square( Random() % TGeometry::HEIGHT, Random() % TGeometry::WIDTH );
+			if ( Ret.GetSquare( Square ) == DEAD ) // SetSquare does not clear the other colour
+				Ret.SetSquare( Square, Random() % 2 ? GOOD : BAD );
+		}
+		return Ret;
+	}
+	std::vector<CGameField> MidGameFields( size_t nMax )
+	{
+		std::vector<CGameField> Ret;
+		for ( const CGame& Game : ReadGames( "SuperDivider", true ) )
+		{
+			for ( size_t i = 10; i < Game.size() && Ret.size() < nMax; i += 10 )
+				Ret.push_back( Game._FieldsAndMoves[i].first );
+		}
+		return Ret;
+	}
+
+	template<typename Functor>
+	void Measure( const std::string& Name, size_t nOps, const Functor& f )
+	{
+		const auto Start = TClock::now();
+		f();
+		const double vNs = std::chrono::duration<double, std::nano>( TClock::now() - Start ).count();
+		std::cout << "  " << std::left << std::setw( 28 ) << Name << std::right
+			<< std::setw( 10 ) << vNs / nOps << " ns/op "
+			<< std::setw( 14 ) << 1e9 * nOps / vNs << " /s" << std::endl;
+	}
+
+	template<typename TGeometry>
+	void BenchmarkKernels( const std::vector<TGameField<TGeometry>>& Fields, int nReps )
+	{
+		using TField = TGameField<TGeometry>;
+		const size_t nOps = Fields.size() * nReps;
+		auto Kernel = [&]( const std::string& Name, TNextFieldKernel<TGeometry> pKernel, int nRepsHere )
+		{
+			Measure( Name, Fields.size() * nRepsHere, [&]() {
+				for ( int rep = 0; rep < nRepsHere; ++rep )
+					for ( const TField& Field : Fields )
+						s_nChecksum += pKernel( Field )._GoodBitMask[rep % TGeometry::WIDTH];
+			} );
+		};
+		Kernel( "NextFieldSlow", &NextFieldSlow<TGeometry>, std::max( 1, nReps / 20 ) );
+		Kernel( "NextFieldFast", &NextFieldFast<TGeometry>, nReps );
+		Kernel( "NextFieldSuperFast", &NextFieldSuperFast<TGeometry>, nReps );
+		Kernel( "NextFieldLookup", &NextFieldLookup<TGeometry>, nReps );
+		Kernel( "NextField", GetNextFieldKernel<TGeometry>(), nReps );
+
+		std::vector<TField> Out( Fields.size() );
+		const ECpuLevel Selected = GetKernelLevel( KERNEL_BATCH_STEP );
+		for ( int nLevel = CPU_PORTABLE; nLevel <= GetCpuLevel(); ++nLevel )
+		{
+			SetKernelLevel( KERNEL_BATCH_STEP, ECpuLevel( nLevel ) );
+			Measure( std::string( "NextFieldBatch " ) + GetCpuLevelName( ECpuLevel( nLevel ) ), nOps, [&]() {
+				for ( int rep = 0; rep < nReps; ++rep )
+				{
+					NextFieldBatch( Fields.data(), Out.data(), Fields.size() );
+					s_nChecksum += Out[rep % Out.size()]._GoodBitMask[0];
+				}
+			} );
+		}
+		SetKernelLevel( KERNEL_BATCH_STEP, Selected );
+		Measure( "NextFieldN<4> (per step)", nOps * 3, [&]() {
+			for ( int rep = 0; rep < nReps; ++rep )
+				for ( const TField& Field : Fields )
+					s_nChecksum += NextFieldN<4>( Field )._nGood[3];
+		} );
+		std::array<TField, 3> Generations;
+		const SClusterCacheStats Before = GetClusterCacheStats();
+		Measure( "NextFieldsClustered 3 (per step)", nOps * 3, [&]() {
+			for ( int rep = 0; rep < nReps; ++rep )
+				for ( const TField& Field : Fields )
+				{
+					NextFieldsClustered( Field, 3, Generations.data() );
+					s_nChecksum += Generations[2]._GoodBitMask[rep % TGeometry::WIDTH];
+				}
+		} );
+		const SClusterCacheStats After = GetClusterCacheStats();
+		std::cout << "    cluster memo: " << After._nHits - Before._nHits << " hits, " << After._nMisses - Before._nMisses << " misses, "
+			<< After._nStepped - Before._nStepped << " stepped" << std::endl;
+	}
+
+	void BenchmarkFieldOperations( const std::vector<CGameField>& Fields, int nReps )
+	{
+		std::vector<std::vector<TMoveIdentifier>> Moves;
+		std::vector<CGameField> PassFields;
+		size_t nMoves = 0;
+		for ( const CGameField& Field : Fields )
+		{
+			Moves.push_back( GetValidMoves( Field, 20 ) );
+			nMoves += Moves.back().size();
+			PassFields.push_back( NextField( Field ) );
+		}
+		const int nMoveReps = std::max( 1, nReps / 10 );
+
+		// Counted in moves, so /s is moves per second. All births of a mid-game board run to the hundred thousands, so a few boards do
+		const size_t nGeneratorFields = std::min<size_t>( Fields.size(), 8 );
+		size_t nAllMoves = 0, nSampledMoves = 0;
+		for ( size_t i = 0; i < nGeneratorFields; ++i )
+		{
+			const CMoveGenerator Generator( Fields[i] );
+			nAllMoves += Generator.size();
+			nSampledMoves += 1 + Generator.GetKillCount() + std::min<size_t>( 200, Generator.GetBirthCount() );
+		}
+		Measure( "CMoveGenerator all", nAllMoves, [&]() {
+			for ( size_t i = 0; i < nGeneratorFields; ++i )
+				CMoveGenerator( Fields[i] ).ForEach( []( const TMoveIdentifier& Move ) { s_nChecksum += Move._nBits; } );
+		} );
+		Measure( "CMoveGenerator sampled 200", nSampledMoves * nMoveReps, [&]() {
+			for ( int rep = 0; rep < nMoveReps; ++rep )
+				for ( size_t i = 0; i < nGeneratorFields; ++i )
+					CMoveGenerator( Fields[i] ).ForEachSampled( 200, []( const TMoveIdentifier& Move ) { s_nChecksum += Move._nBits; } );
+		} );
+		Measure( "GetValidMoves 200", nSampledMoves * nMoveReps, [&]() {
+			for ( int rep = 0; rep < nMoveReps; ++rep )
+				for ( size_t i = 0; i < nGeneratorFields; ++i )
+					s_nChecksum += GetValidMoves( Fields[i], 200 ).size();
+		} );
+
+		Measure( "GetSuccessor", nMoves * nMoveReps, [&]() {
+			for ( int rep = 0; rep < nMoveReps; ++rep )
+				for ( size_t i = 0; i < Fields.size(); ++i )
+					for ( const TMoveIdentifier& Move : Moves[i] )
+						s_nChecksum += Fields[i].GetSuccessor( Move )._nHash;
+		} );
+		Measure( "GetSuccessor (incremental)", nMoves * nMoveReps, [&]() {
+			for ( int rep = 0; rep < nMoveReps; ++rep )
+				for ( size_t i = 0; i < Fields.size(); ++i )
+					for ( const TMoveIdentifier& Move : Moves[i] )
+						s_nChecksum += Fields[i].GetSuccessor( Move, PassFields[i] )._nHash;
+		} );
+		Measure( "Make + Unmake", nMoves * nMoveReps, [&]() {
+			for ( int rep = 0; rep < nMoveReps; ++rep )
+				for ( size_t i = 0; i < Fields.size(); ++i )
+				{
+					CGameField Board = Fields[i];
+					for ( const TMoveIdentifier& Move : Moves[i] )
+					{
+						const auto Undo = Board.Make( Move );
+						s_nChecksum += Board._nHash;
+						Board.Unmake( Undo );
+					}
+				}
+		} );
+		Measure( "GetSymmetries", Fields.size() * nReps, [&]() {
+			for ( int rep = 0; rep < nReps; ++rep )
+				for ( const CGameField& Field : Fields )
+					s_nChecksum += GetSymmetries( Field )[3]._nHash;
+		} );
+		Measure( "IsValidMove", nMoves * nReps, [&]() {
+			for ( int rep = 0; rep < nReps; ++rep )
+				for ( size_t i = 0; i < Fields.size(); ++i )
+					for ( const TMoveIdentifier& Move : Moves[i] )
+						s_nChecksum += Fields[i].IsValidMove( Move, rep % 2 == 0 );
+		} );
+		std::vector<SPackedField> Packed;
+		for ( const CGameField& Field : Fields )
+			Packed.push_back( ToPacked( Field ) );
+		Measure( "NextPacked", Fields.size() * nReps, [&]() {
+			for ( int rep = 0; rep < nReps; ++rep )
+				for ( const SPackedField& Field : Packed )
+					s_nChecksum += NextPacked( Field )._Good[0] & 1;
+		} );
+	}
+
+	// Fuzzing
+	struct SFuzzStats
+	{
+		size_t _nSteps = 0;
+		size_t _nWins = 0;
+		size_t _nEmptyDraws = 0; // Both players died out
+		size_t _nTimeDraws = 0; // MAX_ROUNDS reached
+		size_t _nBatches = 0;
+	};
+
+	template<typename TGeometry>
+	bool ReportMismatch( const char* pWhat, const TGameField<TGeometry>& Field, const TGameField<TGeometry>& Expected, const TGameField<TGeometry>& Got )
+	{
+		std::cout << "Fuzzer mismatch in " << pWhat << std::endl;
+		PrintField( Field );
+		PrintField( Expected );
+		PrintField( Got );
+		std::cout << "winner " << int( Expected._winner ) << " vs " << int( Got._winner ) << std::endl;
+		return false;
+	}
+	template<typename TGeometry>
+	bool IsSameField( const TGameField<TGeometry>& a, const TGameField<TGeometry>& b )
+	{
+		return a == b && a.GetHash() == b.GetHash();
+	}
+
+	template<typename TGeometry>
+	bool FuzzPacked( const TGameField<TGeometry>&, const TGameField<TGeometry>& ) { return true; } // SPackedField only has the default geometry
+	bool FuzzPacked( const CGameField& Field, const CGameField& Expected )
+	{
+		const SPackedField Packed = ToPacked( Field );
+		if ( !IsSameField( Field, FromPacked( Packed ) ) )
+			return ReportMismatch( "ToPacked/FromPacked", Field, Field, FromPacked( Packed ) );
+		const CGameField Got = FromPacked( NextPacked( Packed ) );
+		if ( !IsSameField( Expected, Got ) )
+			return ReportMismatch( "NextPacked", Field, Expected, Got );
+		return true;
+	}
+
+	template<typename TGeometry, typename TRandom>
+	bool FuzzBatch( TRandom& Random, const std::vector<TGameField<TGeometry>>& Seeds ) // Every lane of a batch of random size, out of place and in place, at every level
+	{
+		using TField = TGameField<TGeometry>;
+		std::vector<TField> Fields( 1 + Random() % 300 );
+		std::vector<TField> Expected;
+		for ( TField& Field : Fields )
+		{
+			Field = Seeds.empty() || Random() % 2 ? RandomField<TGeometry>( Random, 20 + Random() % 500 ) : Seeds[Random() % Seeds.size()];
+			Expected.push_back( NextFieldSlow( Field ) );
+		}
+		const ECpuLevel Selected = GetKernelLevel( KERNEL_BATCH_STEP );
+		for ( int nLevel = CPU_PORTABLE; nLevel <= GetCpuLevel(); ++nLevel )
+		{
+			std::vector<TField> Out( Fields.size() );
+			std::vector<TField> InPlace = Fields;
+			SetKernelLevel( KERNEL_BATCH_STEP, ECpuLevel( nLevel ) );
+			NextFieldBatch( Fields.data(), Out.data(), Fields.size() );
+			NextFieldBatch( InPlace.data(), InPlace.data(), InPlace.size() );
+			SetKernelLevel( KERNEL_BATCH_STEP, Selected );
+			for ( size_t i = 0; i < Fields.size(); ++i )
+			{
+				const std::string What = std::string( "NextFieldBatch " ) + GetCpuLevelName( ECpuLevel( nLevel ) ) + ", board " + std::to_string( i ) + " of " + std::to_string( Fields.size() );
+				if ( !IsSameField( Expected[i], Out[i] ) )
+					return ReportMismatch( What.c_str(), Fields[i], Expected[i], Out[i] );
+				if ( !IsSameField( Expected[i], InPlace[i] ) )
+					return ReportMismatch( (What + " in place").c_str(), Fields[i], Expected[i], InPlace[i] );
+			}
+		}
+		return true;
+	}
+
+	template<typename TGeometry, typename TRandom>
+	bool FuzzField( const TGameField<TGeometry>& Field, TRandom& Random, SFuzzStats& Stats )
+	{
+		using TField = TGameField<TGeometry>;
+		const TField Expected = NextFieldSlow( Field );
+		const auto Same = []( const TField& a, const TField& b ) { return IsSameField( a, b ); };
+
+		++Stats._nSteps;
+		if ( Expected._winner == TField::POSITIVE || Expected._winner == TField::NEGATIVE )
+			++Stats._nWins;
+		else if ( Expected._winner == TField::DRAW )
+			++(Expected._time >= MAX_ROUNDS ? Stats._nTimeDraws : Stats._nEmptyDraws);
+
+		for ( auto pKernel : { &NextFieldFast<TGeometry>, &NextFieldSuperFast<TGeometry>, &NextFieldLookup<TGeometry>, GetNextFieldKernel<TGeometry>() } )
+		{
+			const TField Got = pKernel( Field );
+			if ( !Same( Expected, Got ) )
+				return ReportMismatch( "kernel", Field, Expected, Got );
+		}
+		if ( !FuzzPacked( Field, Expected ) )
+			return false;
+		const ECpuLevel Selected = GetKernelLevel( KERNEL_BATCH_STEP );
+		for ( int nLevel = CPU_PORTABLE; nLevel <= GetCpuLevel(); ++nLevel )
+		{
+			TField Batched;
+			SetKernelLevel( KERNEL_BATCH_STEP, ECpuLevel( nLevel ) );
+			NextFieldBatch( &Field, &Batched, 1 );
+			SetKernelLevel( KERNEL_BATCH_STEP, Selected );
+			if ( !Same( Expected, Batched ) )
+				return ReportMismatch( (std::string( "NextFieldBatch " ) + GetCpuLevelName( ECpuLevel( nLevel ) )).c_str(), Field, Expected, Batched );
+		}
+		if ( Field._winner == TField::UNDETERMINED && !Same( Expected, NextFieldN<2>( Field ).Get( 1 ) ) )
+			return ReportMismatch( "NextFieldN", Field, Expected, NextFieldN<2>( Field ).Get( 1 ) );
+		std::array<TField, 3> Clustered;
+		NextFieldsClustered( Field, Clustered.size(), Clustered.data() );
+		TField Stepped = Field;
+		for ( const TField& Got : Clustered )
+		{
+			Stepped = NextFieldSlow( Stepped );
+			if ( !SFieldEqual()( Stepped, Got ) )
+				return ReportMismatch( "NextFieldsClustered", Field, Stepped, Got );
+		}
+
+		// Up to 3 valid toggles on distinct squares, through every successor path
+		TMoveIdentifier Move;
+		TField Toggled = Field;
+		const int nParts = Random() % 2 ? 1 : 3;
+		for ( int i = 0; i < nParts; ++i )
+		{
+			const FieldSquare Square( Random() % TGeometry::HEIGHT, Random() % TGeometry::WIDTH );
+			if ( std::find_if( Move.begin(), Move.end(), [&Square]( const TMovePart& Part ) { return Part.first == Square; } ) != Move.end() )
+				continue;
+			const bool bBirth = Field.GetSquare( Square ) == DEAD;
+			Move.push_back( { Square, bBirth } );
+			Toggled.SetSquare( Square, bBirth ? ELifeMode( Field._player_to_move ) : DEAD );
+		}
+		const TField ExpectedMove = NextFieldSlow( Toggled );
+		if ( !Same( ExpectedMove, Field.GetSuccessor( Move ) ) )
+			return ReportMismatch( "GetSuccessor", Field, ExpectedMove, Field.GetSuccessor( Move ) );
+		if ( !Same( ExpectedMove, Field.GetSuccessor( Move, Expected ) ) )
+			return ReportMismatch( "GetSuccessor (incremental)", Field, ExpectedMove, Field.GetSuccessor( Move, Expected ) );
+		TField Board = Field;
+		const auto Undo = Board.Make( Move );
+		if ( !Same( ExpectedMove, Board ) )
+			return ReportMismatch( "Make", Field, ExpectedMove, Board );
+		Board.Unmake( Undo );
+		if ( !Same( Field, Board ) )
+			return ReportMismatch( "Unmake", Field, Field, Board );
+		bool bIndependent = true;
+		for ( size_t i = 0; i < Move.size(); ++i )
+			for ( size_t j = i + 1; j < Move.size(); ++j )
+				bIndependent = bIndependent && AreIndependent( Move[i].first, Move[j].first );
+		if ( bIndependent )
+		{
+			const auto Deltas = GetSingleToggleDeltas( Field, Expected );
+			TField Composed = Expected;
+			for ( const TMovePart& Part : Move )
+				Composed = ComposeToggleDeltas( Composed, { &*std::find_if( Deltas.begin(), Deltas.end(), [&Part]( const TToggleDelta<TGeometry>& Delta ) { return Delta._Move == Part; } ) } );
+			if ( !Same( ExpectedMove, Composed ) )
+				return ReportMismatch( "ComposeToggleDeltas", Field, ExpectedMove, Composed );
+		}
+		return true;
+	}
+
+	template<typename Functor>
+	void TuneKernel( EKernel Kernel, const Functor& f )
+	{
+		ECpuLevel Best = CPU_PORTABLE;
+		double vBestNs = std::numeric_limits<double>::max();
+		std::cerr << GetKernelName( Kernel ) << ":";
+		for ( int nLevel = CPU_PORTABLE; nLevel <= GetCpuLevel(); ++nLevel )
+		{
+			SetKernelLevel( Kernel, ECpuLevel( nLevel ) );
+			double vNs = std::numeric_limits<double>::max();
+			for ( int rep = 0; rep < 5; ++rep ) // Best of 5, the first run also warms up
+			{
+				const auto Start = TClock::now();
+				f();
+				vNs = std::min( vNs, std::chrono::duration<double, std::nano>( TClock::now() - Start ).count() );
+			}
+			std::cerr << " " << GetCpuLevelName( ECpuLevel( nLevel ) ) << " " << int( vNs / 1000 ) << "us";
+			if ( vNs < vBestNs )
+			{
+				vBestNs = vNs;
+				Best = ECpuLevel( nLevel );
+			}
+		}
+		SetKernelLevel( Kernel, Best );
+		std::cerr << " -> " << GetCpuLevelName( Best ) << std::endl;
+	}
+
+	template<typename TGeometry, typename TRandom>
+	bool FuzzGeometry( size_t nIterations, TRandom& Random, const std::vector<TGameField<TGeometry>>& Seeds, SFuzzStats& Stats )
+	{
+		using TField = TGameField<TGeometry>;
+		for ( size_t i = 0; i < nIterations; ++i )
+		{
+			if ( i % 64 == 0 && !FuzzBatch( Random, Seeds ) )
+				return false;
+			Stats._nBatches += i % 64 == 0;
+			TField Field;
+			switch ( i % 4 )
+			{
+			case 0: Field = RandomField<TGeometry>( Random, 20 + Random() % 500 ); break;
+			case 1: Field = NearEmptyField<TGeometry>( Random ); break;
+			case 2: Field = Seeds.empty() ? RandomField<TGeometry>( Random, 150 ) : Seeds[Random() % Seeds.size()]; break;
+			default: Field = RandomField<TGeometry>( Random, 100 + Random() % 200 ); Field._time = short( MAX_ROUNDS - 1 - Random() % 2 ); break; // Draw by MAX_ROUNDS
+			}
+			// Then follow the pass line for a while, so win detection sees real endings
+			const int nSteps = 1 + Random() % 8;
+			for ( int nStep = 0; nStep < nSteps; ++nStep )
+			{
+				if ( !FuzzField( Field, Random, Stats ) )
+					return false;
+				if ( Field._winner != TField::UNDETERMINED )
+					break;
+				Field = NextFieldSlow( Field );
+			}
+		}
+		return true;
+	}
+}
+
+void RunBenchmarks( int nReps )
+{
+	std::mt19937 Random( 1 );
+	std::vector<std::pair<std::string, std::vector<CGameField>>> Sets( 3 );
+	Sets[0].first = "random";
+	Sets[1].first = "mid-game";
+	Sets[2].first = "near-empty";
+	for ( int i = 0; i < 1000; ++i )
+	{
+		Sets[0].second.push_back( NewField() );
+		Sets[2].second.push_back( NearEmptyField<SDefaultGeometry>( Random ) );
+	}
+	Sets[1].second = MidGameFields( 1000 );
+
+	std::cout << std::fixed << std::setprecision( 1 );
+	for ( const auto& Set : Sets )
+	{
+		if ( Set.second.empty() )
+		{
+			std::cout << Set.first << ": no boards (saved_data missing?)" << std::endl;
+			continue;
+		}
+		std::cout << Set.first << " boards (" << Set.second.size() << "):" << std::endl;
+		BenchmarkKernels( Set.second, nReps );
+		BenchmarkFieldOperations( Set.second, nReps );
+	}
+
+	std::vector<TGameField<SSmallGeometry>> SmallFields;
+	for ( int i = 0; i < 1000; ++i )
+		SmallFields.push_back( NewField<SSmallGeometry>() );
+	std::cout << "small field random boards (" << SmallFields.size() << "):" << std::endl;
+	BenchmarkKernels( SmallFields, nReps );
+	Measure( "NextFieldSWAR", SmallFields.size() * nReps, [&]() {
+		for ( int rep = 0; rep < nReps; ++rep )
+			for ( const auto& Field : SmallFields )
+				s_nChecksum += NextFieldSWAR( Field )._GoodBitMask[rep % SSmallGeometry::WIDTH];
+	} );
+
+	const int nGames = 2000;
+	std::cout << "random games to the end (" << nGames << "):" << std::endl;
+	Measure( "PlayGame( CRandomBot )", nGames / 10, [&]() {
+		const CRandomBot Bot;
+		for ( int i = 0; i < nGames / 10; ++i )
+			s_nChecksum += PlayGame( Bot, Bot ).size();
+	} );
+	Measure( "Rollout", nGames, [&]() {
+		s_nChecksum += Rollout( NewField(), nGames, 1 )._nDraws;
+	} );
+	std::cout << "(" << s_nChecksum << ")" << std::endl;
+}
+
+bool RunConwayFuzzer( size_t nIterations, unsigned int nSeed )
+{
+	std::mt19937 Random( nSeed );
+	SFuzzStats Stats;
+	if ( !FuzzGeometry( nIterations, Random, MidGameFields( 5000 ), Stats ) )
+		return false;
+	if ( !FuzzGeometry( nIterations / 4, Random, std::vector<TGameField<SSmallGeometry>>(), Stats ) )
+		return false;
+	std::cout << "Fuzzer OK: " << Stats._nSteps << " steps, " << Stats._nWins << " wins, "
+		<< Stats._nEmptyDraws << " extinction draws, " << Stats._nTimeDraws << " MAX_ROUNDS draws, " << Stats._nBatches << " batches" << std::endl;
+	return true;
+}
+
+void AutotuneKernels()
+{
+	std::mt19937 Random( 1 );
+	std::vector<CGameField> Fields;
+	for ( int i = 0; i < 256; ++i )
+		Fields.push_back( RandomField<SDefaultGeometry>( Random, 150 ) );
+	std::vector<CGameField> Out( Fields.size() );
+	TuneKernel( KERNEL_BATCH_STEP, [&]() {
+		NextFieldBatch( Fields.data(), Out.data(), Fields.size() );
+		s_nChecksum += Out[0]._nGood;
+	} );
+
+	std::vector<double> X( 256 ), Y( 256 );
+	for ( size_t i = 0; i < X.size(); ++i )
+	{
+		X[i] = double( Random() % 2001 ) / 1000 - 1.0;
+		Y[i] = double( Random() % 2001 ) / 1000 - 1.0;
+	}
+	TuneKernel( KERNEL_DOT_PRODUCT, [&]() {
+		for ( int rep = 0; rep < 1000; ++rep )
+			s_nChecksum += DotProduct( X.data(), Y.data(), X.size() ) > 0.0;
+	} );
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+// Kernel timings and differential fuzzing of every stepping path against NextFieldSlow. Run from main with BENCHMARK defined in settings.h
+void RunBenchmarks( int nReps = 200 ); // Prints ns/step and boards/sec on random, mid-game (saved_data) and near-empty boards
+bool RunConwayFuzzer( size_t nIterations, unsigned int nSeed = 1 ); // Prints the first mismatch and returns false, or prints coverage and returns true
+void AutotuneKernels(); // Times every variant of the dispatched kernels (cpu_dispatch.h) on this CPU, keeps the fastest and reports to std::cerr
@@ -10,22 +10,39 @@
 
 TMoveIdentifier CHeuristicBot::ChooseMove( const CGame& Game ) const
 {
-	int nBestMove = 0;
+	constexpr size_t CHUNK_SIZE = 256; // Moves stepped together by GetSuccessors
+	TMoveIdentifier BestMove;
 	double vBestScore = std::numeric_limits<double>::lowest();
-	CGameField Field = Game.GetLastField();
-	const auto& Moves = GetValidMoves( Field, _nSampleBirths );
-	for ( int i = 0; i < Moves.size(); ++i )
+	const CGameField& Field = Game.GetLastField();
+	const CMoveGenerator Generator( Field );
+	std::vector<TMoveIdentifier> Moves;
+	Moves.reserve( CHUNK_SIZE );
+	auto Evaluate = [&]()
 	{
-		const CMove& Move = *Moves[i];
-		const CGameField Next = Field.GetSuccessor( Move );
-		double vScore = PredictOutcome( Next, Field._player_to_move );
-		if ( vScore > vBestScore )
+		const std::vector<CGameField> Successors = Field.GetSuccessors( Moves );
+		for ( size_t i = 0; i < Moves.size(); ++i )
 		{
-			vBestScore = vScore;
-			nBestMove = i;
+			const double vScore = PredictOutcome( Successors[i], Field._player_to_move );
+			if ( vScore > vBestScore )
+			{
+				vBestScore = vScore;
+				BestMove = Moves[i];
+			}
 		}
-	}
-	return Moves[nBestMove]->GetIdentifierVector();
+		Moves.clear();
+	};
+	auto Add = [&]( const TMoveIdentifier& Move )
+	{
+		Moves.push_back( Move );
+		if ( Moves.size() == CHUNK_SIZE )
+			Evaluate();
+	};
+	if ( _nSampleBirths == -1 )
+		Generator.ForEach( Add );
+	else
+		Generator.ForEachSampled( _nSampleBirths, Add );
+	Evaluate();
+	return BestMove;
 }
 
 void CHeuristicBot::NotifyTimeFactor( double vTimeFactor )
@@ -39,6 +56,12 @@ void CHeuristicBot::NotifyTimeFactor( double vTimeFactor )
 
 TMoveIdentifier CRandomBot::ChooseMove( const CGame& Game ) const
 {
-	const auto& Moves = GetValidMoves( Game.GetLastField(), 200 );
-	return Moves[SafeRand() % Moves.size()]->GetIdentifierVector();
+	// Uniform over pass, the kills and 200 of the births, the same as picking from GetValidMoves( Field, 200 )
+	const CMoveGenerator Generator( Game.GetLastField() );
+	const size_t nKills = Generator.GetKillCount();
+	const size_t nBirths = Generator.GetBirthCount();
+	const size_t nMove = SafeRand() % (1 + nKills + std::min<size_t>( 200, nBirths ));
+	if ( nMove <= nKills )
+		return Generator[nMove];
+	return Generator[1 + nKills + SafeRand() % nBirths];
 }
@@ -12,7 +12,6 @@
 #include <tuple>
 #include <type_traits>
 
-class CGameField;
 class CMove;
 class CGame;
 
@@ -21,6 +20,8 @@ class CBot
 public:
 	virtual TMoveIdentifier ChooseMove( const CGame& Game ) const = 0;
 	virtual void NotifyTimeFactor( double vTimeFactor ) {}
+	virtual bool IsDeterministic() const { return false; } // Same field, same move, whatever its _time, as long as that is more than GetHorizon() plies before MAX_ROUNDS. PlayGame only projects cycles between such bots
+	virtual int GetHorizon() const { return MAX_ROUNDS; } // Plies the move looks ahead. Any closer to MAX_ROUNDS, a lookahead ends in a draw by time
 };
 
 class CHeuristicBot : public CBot
@@ -28,6 +29,7 @@ class CHeuristicBot : public CBot
 public:
 	CHeuristicBot( int nSampleBirths ) : _nSampleBirths( nSampleBirths ) {}
 	TMoveIdentifier ChooseMove( const CGame& Game ) const override;
+	bool IsDeterministic() const override { return _nSampleBirths == -1; }
 
 	virtual double PredictOutcome( const CGameField& Field, int nPlayer ) const = 0;
 
@@ -45,6 +47,8 @@ class CPassBot : public CBot
 {
 public:
 	TMoveIdentifier ChooseMove( const CGame& Game ) const override { return {}; }
+	bool IsDeterministic() const override { return true; }
+	int GetHorizon() const override { return 0; }
 };
 
 class CGameGenerator
@@ -0,0 +1,239 @@
+#include "cluster.h"
+#include "util.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace
+{
+	constexpr size_t MAX_CACHED_CLUSTERS = 1 << 14; // Per thread, the cache starts over when full
+
+	template<int HEIGHT>
+	uint32_t DilateRows( uint32_t x, int nRadius ) // Grows by 1, 2, 4, ... rows
+	{
+		for ( int nDone = 0, nStep = 1; nDone < nRadius; nDone += nStep, nStep *= 2 )
+		{
+			nStep = std::min( nStep, nRadius - nDone );
+			x |= (x << nStep) | (x >> nStep);
+		}
+		return x & ((1u << HEIGHT) - 1);
+	}
+
+	struct SClusterKey
+	{
+		uint64_t _nGood; // Column j of the bounding box in bits 8j to 8j+7, from its first row
+		uint64_t _nBad;
+		uint32_t _nFrame; // Box size, distances to the four edges clipped to the generations, and the generations
+		bool operator==( const SClusterKey& O ) const { return _nGood == O._nGood && _nBad == O._nBad && _nFrame == O._nFrame; }
+	};
+	struct SClusterKeyHasher
+	{
+		size_t operator()( const SClusterKey& Key ) const
+		{
+			uint64_t x = (Key._nGood * 0x9E3779B97F4A7C15ull) ^ (Key._nBad * 0xC2B2AE3D27D4EB4Full) ^ Key._nFrame;
+			x ^= x >> 29;
+			x *= 0xBF58476D1CE4E5B9ull;
+			return size_t( x ^ (x >> 32) );
+		}
+	};
+	struct SClusterEvolution
+	{
+		int _nCols = 0; // The bounding box grown by the generations on every side
+		std::vector<uint32_t> _Columns; // Generation g, colour c (0 good, 1 bad), column j: [(2*g+c)*_nCols + j]. Rows from the box's first row minus the generations
+	};
+
+	thread_local std::unordered_map<SClusterKey, SClusterEvolution, SClusterKeyHasher> s_Cache;
+	thread_local SClusterCacheStats s_Stats;
+
+	template<typename TGeometry>
+	SClusterKey GetKey( const TCluster<TGeometry>& Cluster, int K )
+	{
+		SClusterKey Ret = { 0, 0, 0 };
+		for ( int col = Cluster._nFirstCol; col <= Cluster._nLastCol; ++col )
+		{
+			const int nShift = 8 * (col - Cluster._nFirstCol);
+			Ret._nGood |= uint64_t( Cluster._GoodBitMask[col] >> Cluster._nFirstRow ) << nShift;
+			Ret._nBad |= uint64_t( Cluster._BadBitMask[col] >> Cluster._nFirstRow ) << nShift;
+		}
+		const int nLeft = std::min( Cluster._nFirstCol, K );
+		const int nRight = std::min( TGeometry::WIDTH - 1 - Cluster._nLastCol, K );
+		const int nTop = std::min( Cluster._nFirstRow, K );
+		const int nBottom = std::min( TGeometry::HEIGHT - 1 - Cluster._nLastRow, K );
+		Ret._nFrame = uint32_t( Cluster._nLastCol - Cluster._nFirstCol ) | uint32_t( Cluster._nLastRow - Cluster._nFirstRow ) << 4
+			| uint32_t( nLeft ) << 8 | uint32_t( nRight ) << 12 | uint32_t( nTop ) << 16 | uint32_t( nBottom ) << 20 | uint32_t( K ) << 24;
+		return Ret;
+	}
+
+	template<typename TGeometry>
+	SClusterEvolution StepCluster( const TCluster<TGeometry>& Cluster, int K ) // Steps the cluster alone, where it is
+	{
+		SClusterEvolution Ret;
+		Ret._nCols = Cluster._nLastCol - Cluster._nFirstCol + 1 + 2 * K;
+		Ret._Columns.resize( 2 * K * Ret._nCols );
+		TGameField<TGeometry> Field;
+		Field._GoodBitMask = Cluster._GoodBitMask;
+		Field._BadBitMask = Cluster._BadBitMask;
+		Field.UpdateCounts();
+		for ( int g = 0; g < K; ++g )
+		{
+			Field = NextField( Field );
+			for ( int j = 0; j < Ret._nCols; ++j )
+			{
+				const int col = Cluster._nFirstCol - K + j;
+				if ( col < 0 || col >= TGeometry::WIDTH )
+					continue;
+				const int nShift = Cluster._nFirstRow - K;
+				const uint32_t Good = Field._GoodBitMask[col], Bad = Field._BadBitMask[col];
+				Ret._Columns[(2*g) * Ret._nCols + j] = nShift >= 0 ? Good >> nShift : Good << -nShift;
+				Ret._Columns[(2*g+1) * Ret._nCols + j] = nShift >= 0 ? Bad >> nShift : Bad << -nShift;
+			}
+		}
+		return Ret;
+	}
+
+	template<typename TGeometry>
+	void PasteCluster( const SClusterEvolution& Evolution, const TCluster<TGeometry>& Cluster, int K, TGameField<TGeometry>* pOut )
+	{
+		using COLMASK = typename TGeometry::COLMASK;
+		const int nShift = Cluster._nFirstRow - K;
+		for ( int g = 0; g < K; ++g )
+		{
+			for ( int j = 0; j < Evolution._nCols; ++j )
+			{
+				const int col = Cluster._nFirstCol - K + j;
+				if ( col < 0 || col >= TGeometry::WIDTH )
+					continue;
+				const uint32_t Good = Evolution._Columns[(2*g) * Evolution._nCols + j];
+				const uint32_t Bad = Evolution._Columns[(2*g+1) * Evolution._nCols + j];
+				pOut[g]._GoodBitMask[col] |= COLMASK( nShift >= 0 ? Good << nShift : Good >> -nShift );
+				pOut[g]._BadBitMask[col] |= COLMASK( nShift >= 0 ? Bad << nShift : Bad >> -nShift );
+			}
+		}
+	}
+}
+
+template<typename TGeometry>
+std::vector<TCluster<TGeometry>> GetClusters( const TGameField<TGeometry>& Field, int nGenerations )
+{
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
+	using COLMASK = typename TGeometry::COLMASK;
+	const int nRadius = 2 * nGenerations;
+
+	std::array<uint32_t, WIDTH> Remaining; // Live squares not in a cluster yet
+	for ( int col = 0; col < WIDTH; ++col )
+		Remaining[col] = Field._GoodBitMask[col] | Field._BadBitMask[col];
+
+	std::vector<TCluster<TGeometry>> Ret;
+	for ( int nSeedCol = 0; nSeedCol < WIDTH; ++nSeedCol )
+	{
+		while ( Remaining[nSeedCol] != 0 )
+		{
+			// Flood fill from the lowest square left, nRadius squares at a time from the squares found last
+			std::array<uint32_t, WIDTH> Region = {};
+			Region[nSeedCol] = Remaining[nSeedCol] & (0u - Remaining[nSeedCol]);
+			std::array<uint32_t, WIDTH> Frontier = Region;
+			int nFirst = nSeedCol, nLast = nSeedCol;
+			for ( int nFrontierFirst = nSeedCol, nFrontierLast = nSeedCol; nFrontierFirst <= nFrontierLast; )
+			{
+				std::array<uint32_t, WIDTH> Rows;
+				for ( int col = nFrontierFirst; col <= nFrontierLast; ++col )
+					Rows[col] = DilateRows<HEIGHT>( Frontier[col], nRadius );
+				const int nOldFirst = nFrontierFirst, nOldLast = nFrontierLast;
+				nFrontierFirst = WIDTH;
+				nFrontierLast = -1;
+				for ( int col = std::max( 0, nOldFirst - nRadius ); col <= std::min( WIDTH - 1, nOldLast + nRadius ); ++col )
+				{
+					uint32_t Reach = 0;
+					for ( int c = std::max( nOldFirst, col - nRadius ); c <= std::min( nOldLast, col + nRadius ); ++c )
+						Reach |= Rows[c];
+					Frontier[col] = Reach & Remaining[col] & ~Region[col];
+					if ( Frontier[col] == 0 )
+						continue;
+					Region[col] |= Frontier[col];
+					nFrontierFirst = std::min( nFrontierFirst, col );
+					nFrontierLast = std::max( nFrontierLast, col );
+				}
+				nFirst = std::min( nFirst, nFrontierFirst );
+				nLast = std::max( nLast, nFrontierLast );
+			}
+
+			Ret.emplace_back();
+			TCluster<TGeometry>& Cluster = Ret.back();
+			Cluster._nFirstCol = nFirst;
+			Cluster._nLastCol = nLast;
+			uint32_t AllRows = 0;
+			for ( int col = nFirst; col <= nLast; ++col )
+			{
+				Cluster._GoodBitMask[col] = COLMASK( Field._GoodBitMask[col] & Region[col] );
+				Cluster._BadBitMask[col] = COLMASK( Field._BadBitMask[col] & Region[col] );
+				Remaining[col] &= ~Region[col];
+				AllRows |= Region[col];
+			}
+			Cluster._nFirstRow = PopCount( (AllRows & (0u - AllRows)) - 1 );
+			for ( Cluster._nLastRow = HEIGHT - 1; !((AllRows >> Cluster._nLastRow) & 1); --Cluster._nLastRow ) {}
+		}
+	}
+	return Ret;
+}
+
+template<typename TGeometry>
+void NextFieldsClustered( const TGameField<TGeometry>& Field, size_t nGenerations, TGameField<TGeometry>* pOut )
+{
+	assert( nGenerations <= MAX_CLUSTER_GENERATIONS );
+	const int K = int( nGenerations );
+	for ( int g = 0; g < K; ++g )
+		pOut[g] = TGameField<TGeometry>();
+
+	TGameField<TGeometry> Rest; // Clusters too big to cache, stepped together
+	for ( const TCluster<TGeometry>& Cluster : GetClusters( Field, K ) )
+	{
+		if ( Cluster._nLastCol - Cluster._nFirstCol >= MAX_CACHED_CLUSTER_SIZE || Cluster._nLastRow - Cluster._nFirstRow >= MAX_CACHED_CLUSTER_SIZE )
+		{
+			for ( int col = Cluster._nFirstCol; col <= Cluster._nLastCol; ++col )
+			{
+				Rest._GoodBitMask[col] |= Cluster._GoodBitMask[col];
+				Rest._BadBitMask[col] |= Cluster._BadBitMask[col];
+			}
+			++s_Stats._nStepped;
+			continue;
+		}
+		const SClusterKey Key = GetKey( Cluster, K );
+		auto it = s_Cache.find( Key );
+		if ( it == s_Cache.end() )
+		{
+			++s_Stats._nMisses;
+			if ( s_Cache.size() >= MAX_CACHED_CLUSTERS )
+				s_Cache.clear();
+			it = s_Cache.emplace( Key, StepCluster( Cluster, K ) ).first;
+		}
+		else
+			++s_Stats._nHits;
+		PasteCluster( it->second, Cluster, K, pOut );
+	}
+
+	Rest.UpdateCounts();
+	for ( int g = 0; g < K && Rest._nLiveCols != 0; ++g )
+	{
+		Rest = NextField( Rest );
+		for ( int col = 0; col < TGeometry::WIDTH; ++col )
+		{
+			pOut[g]._GoodBitMask[col] |= Rest._GoodBitMask[col];
+			pOut[g]._BadBitMask[col] |= Rest._BadBitMask[col];
+		}
+	}
+}
+
+SClusterCacheStats GetClusterCacheStats()
+{
+	return s_Stats;
+}
+
+#define INSTANTIATE_CLUSTERS( TGeometry ) \
+	template std::vector<TCluster<TGeometry>> GetClusters( const TGameField<TGeometry>&, int ); \
+	template void NextFieldsClustered( const TGameField<TGeometry>&, size_t, TGameField<TGeometry>* );
+
+INSTANTIATE_CLUSTERS( SSmallGeometry )
+INSTANTIATE_CLUSTERS( SFullGeometry )
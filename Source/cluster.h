@@ -0,0 +1,39 @@
+#pragma once
+
+#include "game_field.h"
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+// Live squares evolve on their own until something grows into reach. Squares closer than 2k+1 (Chebyshev distance) form one cluster,
+// so different clusters cannot touch within k generations and the board's next k generations are the union of each cluster's own
+constexpr int MAX_CLUSTER_GENERATIONS = 8;
+constexpr int MAX_CACHED_CLUSTER_SIZE = 8; // Rows and columns of the bounding box. Bigger clusters are rarely seen twice and are stepped instead
+
+template<typename TGeometry>
+struct TCluster
+{
+	using COLMASK = typename TGeometry::COLMASK;
+	std::array<COLMASK, TGeometry::WIDTH> _GoodBitMask = {};
+	std::array<COLMASK, TGeometry::WIDTH> _BadBitMask = {};
+	int _nFirstCol = 0; // Bounding box
+	int _nLastCol = 0;
+	int _nFirstRow = 0;
+	int _nLastRow = 0;
+};
+template<typename TGeometry>
+std::vector<TCluster<TGeometry>> GetClusters( const TGameField<TGeometry>& Field, int nGenerations ); // Independent for nGenerations steps, ordered by their first column
+
+// Bit masks of generations 1 to nGenerations (at most MAX_CLUSTER_GENERATIONS) of Field in pOut[0] to pOut[nGenerations-1], nothing else. Small clusters come from a
+// per-thread memo keyed by their normalised shape and their distance to the edges (clipped to nGenerations), the rest is stepped together
+template<typename TGeometry>
+void NextFieldsClustered( const TGameField<TGeometry>& Field, size_t nGenerations, TGameField<TGeometry>* pOut );
+
+struct SClusterCacheStats
+{
+	size_t _nHits = 0;
+	size_t _nMisses = 0;
+	size_t _nStepped = 0; // Too big to cache
+};
+SClusterCacheStats GetClusterCacheStats(); // Of the calling thread
@@ -0,0 +1,83 @@
+#include "cpu_dispatch.h"
+
+#include <array>
+#include <algorithm>
+#if defined(CPU_DISPATCH) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	ECpuLevel DetectCpuLevel()
+	{
+#if defined(CPU_DISPATCH) && defined(__GNUC__)
+		__builtin_cpu_init(); // Also checks that the OS saves the wider registers
+		if ( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) )
+			return CPU_AVX512;
+		if ( __builtin_cpu_supports( "avx2" ) )
+			return CPU_AVX2;
+		if ( __builtin_cpu_supports( "sse2" ) )
+			return CPU_SSE2;
+#elif defined(CPU_DISPATCH)
+		int Info[4];
+		__cpuid( Info, 0 );
+		const int nMaxLeaf = Info[0];
+		__cpuid( Info, 1 );
+		const bool bSSE2 = (Info[3] & (1 << 26)) != 0;
+		const unsigned long long nXCR0 = (Info[2] & (1 << 27)) ? _xgetbv( 0 ) : 0; // OSXSAVE: which registers the OS saves
+		bool bAVX2 = false, bAVX512 = false;
+		if ( nMaxLeaf >= 7 )
+		{
+			__cpuidex( Info, 7, 0 );
+			bAVX2 = (Info[1] & (1 << 5)) && (nXCR0 & 0x06) == 0x06;
+			bAVX512 = (Info[1] & (1 << 16)) && (Info[1] & (1 << 30)) && (nXCR0 & 0xE6) == 0xE6; // F and BW, with the mask and upper ZMM state
+		}
+		if ( bAVX512 )
+			return CPU_AVX512;
+		if ( bAVX2 )
+			return CPU_AVX2;
+		if ( bSSE2 )
+			return CPU_SSE2;
+#endif
+		return CPU_PORTABLE;
+	}
+
+	std::array<ECpuLevel, KERNELS>& GetKernelLevels()
+	{
+		static std::array<ECpuLevel, KERNELS> s_Levels = []()
+		{
+			std::array<ECpuLevel, KERNELS> Ret;
+			Ret.fill( GetCpuLevel() );
+			return Ret;
+		}();
+		return s_Levels;
+	}
+}
+
+ECpuLevel GetCpuLevel()
+{
+	static const ECpuLevel s_Level = DetectCpuLevel();
+	return s_Level;
+}
+
+ECpuLevel GetKernelLevel( EKernel Kernel )
+{
+	return GetKernelLevels()[Kernel];
+}
+
+void SetKernelLevel( EKernel Kernel, ECpuLevel Level )
+{
+	GetKernelLevels()[Kernel] = std::min( Level, GetCpuLevel() );
+}
+
+const char* GetCpuLevelName( ECpuLevel Level )
+{
+	static const char* Names[CPU_LEVELS] = { "portable", "SSE2", "AVX2", "AVX-512" };
+	return Names[Level];
+}
+
+const char* GetKernelName( EKernel Kernel )
+{
+	static const char* Names[KERNELS] = { "NextFieldBatch", "DotProduct" };
+	return Names[Kernel];
+}
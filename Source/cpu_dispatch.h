@@ -0,0 +1,33 @@
+#pragma once
+
+// Runtime choice of instruction set for the hot kernels. Every kernel has a portable version, and its variants give the same results.
+// Only the kernels below are dispatched: sparse layers scatter into the output and activations are scalar library calls
+enum ECpuLevel
+{
+	CPU_PORTABLE,
+	CPU_SSE2,
+	CPU_AVX2,
+	CPU_AVX512, // F and BW
+	CPU_LEVELS
+};
+enum EKernel
+{
+	KERNEL_BATCH_STEP, // NextFieldBatch
+	KERNEL_DOT_PRODUCT, // DotProduct in matrix.h, for dense layers
+	KERNELS
+};
+
+ECpuLevel GetCpuLevel(); // Best level of this CPU (CPUID) that the build has variants for
+ECpuLevel GetKernelLevel( EKernel Kernel ); // Defaults to GetCpuLevel()
+void SetKernelLevel( EKernel Kernel, ECpuLevel Level ); // Capped at GetCpuLevel(). Not thread safe, set it before starting any games
+const char* GetCpuLevelName( ECpuLevel Level );
+const char* GetKernelName( EKernel Kernel );
+
+// Variants exist on x86 only. Elsewhere every kernel runs its portable version
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_DISPATCH
+#define CPU_TARGET( ISA ) __attribute__(( target( ISA ), flatten )) // Inlines the portable code, so it is compiled for ISA
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CPU_DISPATCH
+#define CPU_TARGET( ISA ) // MSVC takes intrinsics of any instruction set in any function
+#endif
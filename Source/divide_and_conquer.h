@@ -6,7 +6,12 @@
 #include "nn_bot.h"
 #include "game_field.h"
 #include "input_data.h"
+#include "move.h"
+#include "move_ordering.h"
+#include "successor_scores.h"
 #include <algorithm>
+#include <set>
+#include <queue>
 
 template<typename... Ts>
 class CDivideAndConquer : public CNNBot<Ts...>
@@ -17,18 +22,33 @@ protected:
 		std::vector<std::pair<double, TMovePart>> _Birth;
 		std::vector<std::pair<double, TMovePart>> _KillMe;
 		std::vector<std::pair<double, TMovePart>> _KillEnemy;
+		std::vector<CToggleDelta> _Deltas; // Of every single toggle, if the division stepped them all (CreateDivision). Lets ProposeMovesFromDivision compose triples
 		template<typename T>
 		bool operator==( const T& Other ) const { return _Birth == Other._Birth && _KillMe == Other._KillMe && _KillEnemy == Other._KillEnemy; }
 	};
+	using SLatticePoint = std::array<size_t, 3>; // Indices into _Birth, _KillMe and _KillMe
+	struct SSearch // Move ordering and dedup counts of one root search. A subtree on another thread gets a Fork, merged back when it is done
+	{
+		CMoveOrdering _Ordering;
+		SSuccessorDedupStats _DedupStats;
+		SSearch Fork() const { return { _Ordering.Fork(), {} }; }
+		void Merge( const SSearch& Fork ) { _Ordering.Merge( Fork._Ordering ); _DedupStats.Add( Fork._DedupStats ); }
+	};
 public:
 	using TBaseClass = CNNBot<Ts...>;
 	template<typename... TInits>
 	CDivideAndConquer( TInits... Inits ) : TBaseClass( std::forward<TInits>(Inits)... ) {}
 
 	template<size_t RECURSION>
-	TMoveIdentifier ChooseMoveFromDivision( const CGameField& Field, const SDivision& Division,
+	TMoveIdentifier ChooseMoveFromDivision( CGameField& Field, const SDivision& Division, SSearch& Search, // Field is made and unmade on, and left as it was
 		double* pAverageScore = nullptr, double vAlpha = -2.0, double vBeta = 2.0 ) const;
 	TMoveIdentifier ChooseMove( const CGame& Game ) const override;
+#ifdef TESTING
+	bool IsDeterministic() const override { return true; }
+#else
+	bool IsDeterministic() const override { return false; } // The subtree searched by std::async can come back sooner or later
+#endif
+	int GetHorizon() const override { return int( _ParametersPerDepth.size() ) + TBaseClass::GetHorizon(); } // Plies searched, then the net on their successors
 
 	void NotifyTimeFactor( double vTimeFactor ) override;
 
@@ -38,12 +58,13 @@ public:
 
 	double PredictOutcome( const CGameField& Field, int nPlayer ) const override;
 private:
-	SDivision CreateDivision( const CGameField& Field ) const;
+	SDivision CreateDivision( const CGameField& Field, SSuccessorDedupStats& DedupStats ) const;
 protected:
-	virtual SDivision CreateDivisionFast( const CGameField& Field, int nRecursionDepth ) const { return CreateDivision( Field ); }
-	virtual void ProposeMovesFromDivision( CCandidateList<TMoveIdentifier>& Candidates, const SDivision& Division, const CGameField& Field, int nSamples ) const;
+	virtual SDivision CreateDivisionFast( const CGameField& Field, int nRecursionDepth, SSuccessorDedupStats& DedupStats ) const { return CreateDivision( Field, DedupStats ); }
+	virtual void ProposeMovesFromDivision( CCandidateList<TMoveIdentifier>& Candidates, const SDivision& Division, const CGameField& Field, int nSamples,
+		double vPassScore, SSuccessorDedupStats& DedupStats ) const; // vPassScore = PredictOutcome of NextField( Field )
 	template<size_t RECURSION>
-	CCandidateList<TMoveIdentifier> DoDeepSearch( const CGameField& Field, const CCandidateList<TMoveIdentifier>& Suggested, int nOutput, double vAlpha, double vBeta, bool bUseThreads ) const;
+	CCandidateList<TMoveIdentifier> DoDeepSearch( CGameField& Field, const CCandidateList<TMoveIdentifier>& Suggested, int nOutput, double vAlpha, double vBeta, bool bUseThreads, SSearch& Search ) const;
 public:
 	struct SParameters
 	{
@@ -79,36 +100,35 @@ double CDivideAndConquer<Ts...>::PredictOutcome( const CGameField& Field, int nP
 }
 
 template<typename ...Ts>
-typename CDivideAndConquer<Ts...>::SDivision CDivideAndConquer<Ts...>::CreateDivision( const CGameField& Field ) const
+typename CDivideAndConquer<Ts...>::SDivision CDivideAndConquer<Ts...>::CreateDivision( const CGameField& Field, SSuccessorDedupStats& DedupStats ) const
 {
 	SDivision Ret;
 	const CGameField PassField = NextField( Field );
+	CSuccessorScores Scores( DEDUP_DIVISION, DedupStats ); // PredictOutcome once per distinct successor
 	bool bFirstPassBirth = true;
-	for ( bool bBirth : { true, false } )
+	Ret._Deltas = GetSingleToggleDeltas( Field, PassField );
+	for ( const CToggleDelta& Delta : Ret._Deltas ) // Every valid single toggle, births first
 	{
-		for ( const FieldSquare& Square : AllFieldSquares )
+		const FieldSquare& Square = Delta._Move.first;
+		const bool bBirth = Delta._Move.second;
+		const bool bInert = IsInertToggle( Field, Square ); // Successor is PassField, no need to step it
+		CGameField NextField = bInert ? PassField : Delta.GetSuccessor( PassField );
+		if ( bBirth && (bInert || NextField == PassField) )
 		{
-			TMoveIdentifier Move = { std::make_pair( Square, bBirth ) };
-			if ( !Field.IsValidMove( Move, false ) )
+			if ( !bFirstPassBirth )
 				continue;
-			CGameField NextField = Field.GetSuccessor( Move );
-			if ( bBirth && NextField == PassField )
-			{
-				if ( !bFirstPassBirth )
-					continue;
-				bFirstPassBirth = false;
-			}
-			const double vScore = this->PredictOutcome( NextField, Field._player_to_move );
-			ELifeMode X = Field.GetSquare( Square );
-			if ( X == DEAD )
-				Ret._Birth.emplace_back( vScore, Move[0] );
+			bFirstPassBirth = false;
+		}
+		const double vScore = Scores.GetScore( NextField.GetHash(), [&]() { return this->PredictOutcome( NextField, Field._player_to_move ); } );
+		ELifeMode X = Field.GetSquare( Square );
+		if ( X == DEAD )
+			Ret._Birth.emplace_back( vScore, Delta._Move );
+		else
+		{
+			if ( X == Field._player_to_move )
+				Ret._KillMe.emplace_back( vScore, Delta._Move );
 			else
-			{
-				if ( X == Field._player_to_move )
-					Ret._KillMe.emplace_back( vScore, Move[0] );
-				else
-					Ret._KillEnemy.emplace_back( vScore, Move[0] );
-			}
+				Ret._KillEnemy.emplace_back( vScore, Delta._Move );
 		}
 	}
 	// Sort, greatest first
@@ -120,37 +140,83 @@ typename CDivideAndConquer<Ts...>::SDivision CDivideAndConquer<Ts...>::CreateDiv
 }
 
 template<typename ...Ts>
-void CDivideAndConquer<Ts...>::ProposeMovesFromDivision( CCandidateList<TMoveIdentifier>& Candidates, const SDivision& Division, const CGameField& Field, int nSamples ) const
+void CDivideAndConquer<Ts...>::ProposeMovesFromDivision( CCandidateList<TMoveIdentifier>& Candidates, const SDivision& Division, const CGameField& Field, int nSamples,
+	double vPassScore, SSuccessorDedupStats& DedupStats ) const
 {
+	if ( Division._Birth.empty() || Division._KillMe.size() < 2 )
+		return;
+	const CGameField PassField = NextField( Field );
+	const CMoveEquivalence Equivalence = Division._Deltas.empty() ? CMoveEquivalence( Field, PassField ) : CMoveEquivalence( Field, PassField, Division._Deltas );
+	std::set<TMoveIdentifier> Classes = { {} }; // Pass and the single kills are proposed by ChooseMoveFromDivision
+	for ( const auto& Kill : Division._KillMe )
+		Classes.insert( Equivalence.GetClass( { Kill.second } ) );
+	for ( const auto& Kill : Division._KillEnemy )
+		Classes.insert( Equivalence.GetClass( { Kill.second } ) );
+	CSuccessorScores Successors( DEDUP_COMBINATIONS, DedupStats ); // Different classes can still meet in one board
+	Successors.Insert( PassField.GetHash() );
+
+	// Parts far apart change the next generation independently, so their successor is put together from the single toggles
+	std::array<const CToggleDelta*, WIDTH*HEIGHT> DeltaAt = {}; // By ToInt of the square, a square is either born or killed
+	for ( const CToggleDelta& Delta : Division._Deltas )
+		DeltaAt[ToInt( Delta._Move.first )] = &Delta;
+	auto GetSuccessor = [&Field, &PassField, &DeltaAt]( const TMoveIdentifier& Move )
+	{
+		const FieldSquare Birth = Move[0].first, Sacrifice1 = Move[1].first, Sacrifice2 = Move[2].first;
+		if ( DeltaAt[ToInt( Birth )] && AreIndependent( Birth, Sacrifice1 ) && AreIndependent( Birth, Sacrifice2 ) && AreIndependent( Sacrifice1, Sacrifice2 ) )
+			return ComposeToggleDeltas( PassField, { DeltaAt[ToInt( Birth )], DeltaAt[ToInt( Sacrifice1 )], DeltaAt[ToInt( Sacrifice2 )] } );
+		return Field.GetSuccessor( Move, PassField );
+	};
+
+	// Best first over ( birth, sacrifice 1, sacrifice 2 ) indices with a product of ranks up to nMaxProduct, by the sum of their single scores.
+	// Taken as additive, that sum is what the triple should score: once it cannot get into Candidates, no triple after it can either
 	const size_t nMaxProduct = size_t( std::ceil( 0.5852 * std::pow( nSamples*2, 0.7042 ) ) ); // nSamples*2 ~ A061201(nMaxProduct). A061201(n) is the number of ordered triples (a,b,c) such that a*b*c <= n.
-	for ( size_t nBirth = 0; nBirth < Division._Birth.size(); ++nBirth )
+	auto GetSum = [&Division]( const SLatticePoint& Point )
 	{
-		const size_t nMaxSacrifice1 = std::min( Division._KillMe.size(), nMaxProduct / (1 + nBirth) );
-		for ( size_t nSacrifice1 = 0; nSacrifice1 < nMaxSacrifice1; ++nSacrifice1 )
+		return Division._Birth[Point[0]].first + Division._KillMe[Point[1]].first + Division._KillMe[Point[2]].first;
+	};
+	std::priority_queue<std::pair<double, SLatticePoint>> Queue;
+	std::set<SLatticePoint> Queued;
+	auto Push = [&]( const SLatticePoint& Point ) // The region is closed downwards, so every point in it is reached
+	{
+		const size_t nBirth = Point[0], nSacrifice1 = Point[1], nSacrifice2 = Point[2];
+		if ( nBirth < Division._Birth.size() && nSacrifice1 < nSacrifice2 && nSacrifice2 < Division._KillMe.size()
+			&& nSacrifice1 < nMaxProduct / (1 + nBirth) && nSacrifice2 < 1 + nMaxProduct / ((1 + nBirth) * (1 + nSacrifice1))
+			&& Queued.insert( Point ).second )
 		{
-			const size_t nMaxSacrifice2 = std::min(
-				Division._KillMe.size(),
-				1 + nMaxProduct / ((1+nBirth) * (1+nSacrifice1))
-			);
-			for ( size_t nSacrifice2 = nSacrifice1+1; nSacrifice2 < nMaxSacrifice2; ++nSacrifice2 )
-			{
-				TMoveIdentifier Candidate = {
-					Division._Birth[nBirth].second,
-					Division._KillMe[nSacrifice1].second,
-					Division._KillMe[nSacrifice2].second
-				};
-				const double vScore = this->PredictOutcome( Field.GetSuccessor( Candidate ), Field._player_to_move );
-				Candidates.Propose( vScore, Candidate );
-			}
+			Queue.emplace( GetSum( Point ), Point );
 		}
+	};
+	Push( { 0, 0, 1 } );
+	while ( !Queue.empty() )
+	{
+		const SLatticePoint Point = Queue.top().second;
+		const double vEstimate = Queue.top().first - 2 * vPassScore;
+		Queue.pop();
+		if ( vEstimate < Candidates.GetLeastScore() )
+			break;
+		Push( { Point[0] + 1, Point[1], Point[2] } );
+		Push( { Point[0], Point[1] + 1, Point[2] } );
+		Push( { Point[0], Point[1], Point[2] + 1 } );
+
+		TMoveIdentifier Candidate = {
+			Division._Birth[Point[0]].second,
+			Division._KillMe[Point[1]].second,
+			Division._KillMe[Point[2]].second
+		};
+		if ( !Classes.insert( Equivalence.GetClass( Candidate ) ).second )
+			continue; // Same successor as a move proposed before
+		const CGameField Successor = GetSuccessor( Candidate );
+		if ( !Successors.Insert( Successor.GetHash() ) )
+			continue;
+		Candidates.Propose( this->PredictOutcome( Successor, Field._player_to_move ), Candidate );
 	}
 }
 
 template<typename ...Ts>
 template<size_t RECURSION>
 CCandidateList<TMoveIdentifier> CDivideAndConquer<Ts...>::DoDeepSearch(
-	const CGameField& Field, const CCandidateList<TMoveIdentifier>& Suggested, int nOutput,
-	double vAlpha, double vBeta, bool bUseThreads ) const
+	CGameField& Field, const CCandidateList<TMoveIdentifier>& Suggested, int nOutput,
+	double vAlpha, double vBeta, bool bUseThreads, SSearch& Search ) const
 {
 #ifdef TESTING
 	bUseThreads = false;
@@ -161,64 +227,94 @@ CCandidateList<TMoveIdentifier> CDivideAndConquer<Ts...>::DoDeepSearch(
 	CCandidateList<TMoveIdentifier> Output( nOutput );
 
 	const auto& Me = *this;
-	auto DoSearch = [&Field, &Me, nNextSeriousCandidates]( TMoveIdentifier Move, double vScore, double vAlpha, double vBeta )
+	auto DoSearch = [&Me]( CGameField& Board, SSearch& Search, TMoveIdentifier Move, double vScore, double vAlpha, double vBeta ) // Board with Move made
 	{
 		constexpr size_t NEXT_RECURSION = RECURSION < 10 ? RECURSION + 1 : 0;
-		CGameField SimulatedField = Field.GetSuccessor( Move );
-		if ( SimulatedField._winner == CGameField::UNDETERMINED && nNextSeriousCandidates > 0 )
+		if ( Board._winner == CGameField::UNDETERMINED )
 		{
-			Me.ChooseMoveFromDivision<NEXT_RECURSION>(
-				SimulatedField, Me.CreateDivisionFast( SimulatedField, NEXT_RECURSION ),
+			Me.template ChooseMoveFromDivision<NEXT_RECURSION>(
+				Board, Me.CreateDivisionFast( Board, NEXT_RECURSION, Search._DedupStats ), Search,
 				&vScore, vAlpha, vBeta );
 			vScore *= -1;
 		}
 		return std::make_pair( Move, vScore );
 	};
-	auto RecordResult = [&vAlpha, &vBeta, &AllScores, &Output, &Field]( TMoveIdentifier Move, double vScore )
+	CMoveOrdering& Ordering = Search._Ordering;
+	const int nDepthLeft = int( _ParametersPerDepth.size() ) - int( RECURSION );
+	const int nPlayer = Field._player_to_move, nPly = Field._time; // Field is made on below
+	auto RecordResult = [&vAlpha, &vBeta, &AllScores, &Output, &Ordering, nDepthLeft, nPlayer, nPly]( TMoveIdentifier Move, double vScore )
 	{
 		AllScores.push_back( vScore );
+		Ordering.NotifySearched();
 		if ( vScore > Output.GetLeastScore() )
 		{
 			Output.Propose( vScore, Move );
-			if ( Field._player_to_move == 1 )
+			if ( nPlayer == 1 )
 				vAlpha = std::max( Output.GetLeastScore(), vAlpha );
 			else
 				vBeta = std::min( -Output.GetLeastScore(), vBeta );
 			if ( vAlpha >= vBeta )
+			{
+				Ordering.NotifyCutoff( Move, nPly, nDepthLeft, AllScores.size() );
 				return true;
+			}
 		}
 		return false;
 	};
 
 	std::future<std::pair<TMoveIdentifier, double>> Future;
+	std::unique_ptr<SSearch> pAsyncSearch; // Forked for the subtree in Future
+	auto CollectFuture = [&Future, &Search, &pAsyncSearch, &RecordResult]()
+	{
+		const auto Result = Future.get();
+		Search.Merge( *pAsyncSearch );
+		return RecordResult( Result.first, Result.second );
+	};
 
+	CSuccessorScores Searched( DEDUP_DEEP_SEARCH, Search._DedupStats ); // Candidates with the same successor have the same subtree
+	// Killers, then the static scores tipped by history. Each entry is ( ordering key, ( static score, move ) )
+	std::vector<std::pair<double, std::pair<double, TMoveIdentifier>>> Ordered;
+	Ordered.reserve( Suggested.Get().size() );
 	for ( auto it = Suggested.Get().rbegin(); it != Suggested.Get().rend(); ++it )
+		Ordered.emplace_back( it->first + Ordering.GetBonus( it->second, nPly ), *it );
+	std::stable_sort( Ordered.begin(), Ordered.end(), []( const auto& a, const auto& b ) { return a.first > b.first; } );
+	for ( const auto& Entry : Ordered )
 	{
-		const auto& Candidate = *it;
-		if ( bUseThreads )
+		const auto& Candidate = Entry.second;
+		if ( bUseThreads && Future.valid() &&
+			Future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready && CollectFuture() )
 		{
-			if ( Future.valid() &&
-				Future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
-			{
-				auto Result = Future.get();
-				if ( RecordResult( Result.first, Result.second ) )
-					break;
-			}
-			if ( !Future.valid() )
+			break;
+		}
+		if ( nNextSeriousCandidates == 0 ) // A leaf keeps its static score, the move is not even made
+		{
+			if ( RecordResult( Candidate.second, Candidate.first ) )
+				break;
+			continue;
+		}
+		const CGameField::SUndo Undo = Field.Make( Candidate.second );
+		if ( !Searched.Insert( Field.GetHash() ) )
+		{
+			Field.Unmake( Undo );
+			continue;
+		}
+		if ( bUseThreads && !Future.valid() )
+		{
+			pAsyncSearch.reset( new SSearch( Search.Fork() ) );
+			Future = std::async( [DoSearch, AsyncBoard = Field, pSearch = pAsyncSearch.get(), Candidate, vAlpha, vBeta]() mutable // Its own board, the rest go on in Field
 			{
-				Future = std::async( DoSearch, Candidate.second, Candidate.first, vAlpha, vBeta );
-				continue;
-			}
+				return DoSearch( AsyncBoard, *pSearch, Candidate.second, Candidate.first, vAlpha, vBeta );
+			} );
+			Field.Unmake( Undo );
+			continue;
 		}
-		auto Result = DoSearch( Candidate.second, Candidate.first, vAlpha, vBeta );
+		auto Result = DoSearch( Field, Search, Candidate.second, Candidate.first, vAlpha, vBeta );
+		Field.Unmake( Undo );
 		if ( RecordResult( Result.first, Result.second ) )
 			break;
 	}
 	if ( bUseThreads && Future.valid() )
-	{
-		auto Result = Future.get();
-		RecordResult( Result.first, Result.second );
-	}
+		CollectFuture();
 #ifdef _DEBUG
 	if ( RECURSION == 0 && nOutput == 1 )
 	{
@@ -234,6 +330,8 @@ CCandidateList<TMoveIdentifier> CDivideAndConquer<Ts...>::DoDeepSearch(
 		}
 //		std::cout << std::endl;
 		std::cout << i;
+		PrintSuccessorDedupStats( std::cout, Search._DedupStats );
+		Ordering.PrintStats( std::cout );
 	}
 #endif
 	return Output;
@@ -242,8 +340,8 @@ CCandidateList<TMoveIdentifier> CDivideAndConquer<Ts...>::DoDeepSearch(
 template<typename ...Ts>
 template<size_t RECURSION>
 TMoveIdentifier CDivideAndConquer<Ts...>::ChooseMoveFromDivision(
-	const CGameField& Field,
-	const typename CDivideAndConquer<Ts...>::SDivision& Division,
+	CGameField& Field,
+	const typename CDivideAndConquer<Ts...>::SDivision& Division, SSearch& Search,
 	double* pAverageScore, double vAlpha, double vBeta ) const
 {
 	const int nDeepSearch = RECURSION < _ParametersPerDepth.size()
@@ -259,20 +357,21 @@ TMoveIdentifier CDivideAndConquer<Ts...>::ChooseMoveFromDivision(
 
 	CCandidateList<TMoveIdentifier> Candidates( _ParametersPerDepth[RECURSION]._nBroadSearch );
 
-	Candidates.Propose( this->PredictOutcome( NextField( Field ), Field._player_to_move ), {} );
+	const double vPassScore = this->PredictOutcome( NextField( Field ), Field._player_to_move );
+	Candidates.Propose( vPassScore, {} );
 	for ( const auto& Kill : Division._KillMe )
 		Candidates.Propose( Kill.first, { Kill.second } );
 	for ( const auto& Kill : Division._KillEnemy )
 		Candidates.Propose( Kill.first, { Kill.second } );
 
-	ProposeMovesFromDivision( Candidates, Division, Field, _ParametersPerDepth[RECURSION]._nCombinationSamples );
+	ProposeMovesFromDivision( Candidates, Division, Field, _ParametersPerDepth[RECURSION]._nCombinationSamples, vPassScore, Search._DedupStats );
 
 	if ( RECURSION < _ParametersPerDepth.size() - 2 )
 	{
-		Candidates = DoDeepSearch<RECURSION+1>( Field, Candidates, _ParametersPerDepth[RECURSION]._nDeepSearch, -1.0, 1.0, RECURSION == 0 );
+		Candidates = DoDeepSearch<RECURSION+1>( Field, Candidates, _ParametersPerDepth[RECURSION]._nDeepSearch, -1.0, 1.0, RECURSION == 0, Search );
 	}
 
-	auto Result = DoDeepSearch<RECURSION>( Field, Candidates, 1, vAlpha, vBeta, RECURSION == 0 );
+	auto Result = DoDeepSearch<RECURSION>( Field, Candidates, 1, vAlpha, vBeta, RECURSION == 0, Search );
 	auto itBest = Result.Get().begin();
 	if ( pAverageScore )
 		*pAverageScore = itBest->first;
@@ -282,10 +381,11 @@ TMoveIdentifier CDivideAndConquer<Ts...>::ChooseMoveFromDivision(
 template<typename ...Ts>
 TMoveIdentifier CDivideAndConquer<Ts...>::ChooseMove( const CGame& Game ) const
 {
-	const CGameField& Field = Game.GetLastField();
+	CGameField Field = Game.GetLastField(); // The one board the search makes and unmakes moves on
 
-	SDivision Division = CreateDivision( Field );
-	return ChooseMoveFromDivision<0>( Field, Division );
+	SSearch Search;
+	SDivision Division = CreateDivision( Field, Search._DedupStats );
+	return ChooseMoveFromDivision<0>( Field, Division, Search );
 }
 
 template<typename... Ts>
@@ -306,7 +406,8 @@ void CDivideAndConquer<Ts...>::NotifyTimeFactor( double vTimeFactor )
 template<typename... Ts>
 void CDivideAndConquer<Ts...>::PrintRanking( const CGameField& Field, const std::vector<TMoveIdentifier>& Moves ) const
 {
-	SDivision Division = CreateDivisionFast( Field, this->_nSampleBirths );
+	SSuccessorDedupStats DedupStats;
+	SDivision Division = CreateDivisionFast( Field, this->_nSampleBirths, DedupStats );
 
 	auto PrintPosition = []( const TMovePart& MovePart, const decltype(Division._Birth)& Container )
 	{
@@ -356,7 +457,8 @@ double CDivideAndConquer<Ts...>::FillPropagationData( CPropagationData<3, SIZE_P
 	{
 		Output.AccessData( nDepth, i ) = -1.0;
 	}
-	SDivision Division = CreateDivision( Field );
+	SSuccessorDedupStats DedupStats;
+	SDivision Division = CreateDivision( Field, DedupStats );
 	std::vector< const decltype(Division._Birth)* > Data = { &Division._Birth, &Division._KillMe, &Division._KillEnemy };
 	for ( int nDepth = 0; nDepth < 3; ++nDepth )
 	{
@@ -10,10 +10,11 @@ public:
 	{}
 	TPolicyNet _PolicyNet;
 protected:
-	typename CDivideAndConquer<Ts...>::SDivision CreateDivisionFast( const CGameField& Field, int nRecursionDepth ) const override;
+	typename CDivideAndConquer<Ts...>::SDivision CreateDivisionFast( const CGameField& Field, int nRecursionDepth, SSuccessorDedupStats& DedupStats ) const override;
 	typename CDivideAndConquer<Ts...>::SDivision CreateDivisionFastX( const CGameField& Field, int nRecursionDepth ) const;
 	
-	void ProposeMovesFromDivision( CCandidateList<TMoveIdentifier>& Candidates, const typename CDivideAndConquer<Ts...>::SDivision& Division, const CGameField& Field, int nSamples ) const override;
+	void ProposeMovesFromDivision( CCandidateList<TMoveIdentifier>& Candidates, const typename CDivideAndConquer<Ts...>::SDivision& Division, const CGameField& Field, int nSamples,
+		double vPassScore, SSuccessorDedupStats& DedupStats ) const override;
 };
 
 template<typename TPolicyNet, typename... Ts>
@@ -23,7 +24,7 @@ auto MakeFast( const TPolicyNet& PolicyNet, const CDivideAndConquer<Ts...>& Base
 }
 
 template<typename TPolicyNet, typename ...Ts>
-auto CFastDivideAndConquer<TPolicyNet, Ts...>::CreateDivisionFast( const CGameField& Field, int nRecursionDepth ) const
+auto CFastDivideAndConquer<TPolicyNet, Ts...>::CreateDivisionFast( const CGameField& Field, int nRecursionDepth, SSuccessorDedupStats& DedupStats ) const
 -> typename CDivideAndConquer<Ts...>::SDivision
 {
 	CPropagationData<3, WIDTH*HEIGHT, 0> Policy =
@@ -58,6 +59,7 @@ auto CFastDivideAndConquer<TPolicyNet, Ts...>::CreateDivisionFast( const CGameFi
 	}
 	bool bFirstNullBirth = true;
 	const CGameField PassField = NextField( Field );
+	CSuccessorScores Scores( DEDUP_DIVISION, DedupStats ); // PredictOutcome once per distinct successor
 	typename CDivideAndConquer<Ts...>::SDivision Division;
 	std::vector< decltype(Division._Birth)* > Output = { &Division._Birth, &Division._KillMe, &Division._KillEnemy };
 	for ( int i = 0; i < 3; ++i )
@@ -65,14 +67,15 @@ auto CFastDivideAndConquer<TPolicyNet, Ts...>::CreateDivisionFast( const CGameFi
 		Output[i]->reserve( Candidates[i]->Get().size() );
 		for ( const auto& Candidate : Candidates[i]->Get() )
 		{
-			const CGameField Next = Field.GetSuccessor( { Candidate.second } );
-			if ( Candidate.second.second && Next == PassField )
+			const bool bInert = IsInertToggle( Field, Candidate.second.first ); // Successor is PassField, no need to step it
+			const CGameField Next = bInert ? PassField : Field.GetSuccessor( { Candidate.second }, PassField );
+			if ( Candidate.second.second && (bInert || Next == PassField) )
 			{
 				if ( !bFirstNullBirth )
 					continue;
 				bFirstNullBirth = false;
 			}
-			Output[i]->emplace_back( this->PredictOutcome( Next, Field._player_to_move ), Candidate.second );
+			Output[i]->emplace_back( Scores.GetScore( Next.GetHash(), [&]() { return this->PredictOutcome( Next, Field._player_to_move ); } ), Candidate.second );
 		}
 	}
 
@@ -87,7 +90,7 @@ template<typename TPolicyNet, typename... Ts>
 void CFastDivideAndConquer<TPolicyNet, Ts...>::ProposeMovesFromDivision(
 	CCandidateList<TMoveIdentifier>& Candidates,
 	const typename CDivideAndConquer<Ts...>::SDivision& Division,
-	const CGameField& Field, int nSamples ) const
+	const CGameField& Field, int nSamples, double vPassScore, SSuccessorDedupStats& DedupStats ) const
 {
-	this->CDivideAndConquer<Ts...>::ProposeMovesFromDivision( Candidates, Division, Field, nSamples );
+	this->CDivideAndConquer<Ts...>::ProposeMovesFromDivision( Candidates, Division, Field, nSamples, vPassScore, DedupStats );
 }
\ No newline at end of file
@@ -2,27 +2,80 @@
 #include "move.h"
 #include "bot.h"
 #include "util.h"
+#include "cpu_dispatch.h"
+#include "cluster.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#ifdef CPU_DISPATCH
+#include <immintrin.h>
+#endif
 
 ELifeMode operator-( ELifeMode x )
 {
 	return ELifeMode( -(signed char) x );
 }
 
-int ToInt( FieldSquare x )
+// Zobrist hashing. Keys are combined per 4 rows, so a whole column is hashed with a few lookups
+namespace
 {
-	return x.first*WIDTH+x.second;
+	template<typename TGeometry>
+	using TZobristTables = std::array<std::array<std::array<std::array<uint64_t, 16>, 2 * sizeof( typename TGeometry::COLMASK )>, TGeometry::WIDTH>, 2>; // [bad][col][row/4][4 row bits]
+	constexpr uint64_t PLAYER_KEY = 0x5BD1E9955BD1E995; // Xored in when _player_to_move == -1
+
+	template<typename TGeometry>
+	const TZobristTables<TGeometry>& GetZobristTables()
+	{
+		static const TZobristTables<TGeometry> Ret = []() {
+			TZobristTables<TGeometry> Tables = {};
+			uint64_t nState = 0x9E3779B97F4A7C15; // SplitMix64 with fixed seed, so keys are the same every run
+			auto NextKey = [&nState]()
+			{
+				uint64_t z = (nState += 0x9E3779B97F4A7C15);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+				return z ^ (z >> 31);
+			};
+			for ( auto& Colour : Tables ) for ( auto& Column : Colour ) for ( auto& Nibble : Column )
+			{
+				std::array<uint64_t, 4> Keys;
+				for ( uint64_t& nKey : Keys )
+					nKey = NextKey();
+				for ( int nBits = 0; nBits < 16; ++nBits )
+					for ( int i = 0; i < 4; ++i )
+						if ( (nBits >> i) & 1 )
+							Nibble[nBits] ^= Keys[i];
+			}
+			return Tables;
+		}();
+		return Ret;
+	}
+
+	template<typename TGeometry>
+	inline uint64_t GetColumnHash( int col, typename TGeometry::COLMASK Good, typename TGeometry::COLMASK Bad )
+	{
+		const TZobristTables<TGeometry>& Tables = GetZobristTables<TGeometry>();
+		uint64_t nRet = 0;
+		for ( int nNibble = 0; nNibble < int( 2 * sizeof( Good ) ); ++nNibble )
+		{
+			nRet ^= Tables[0][col][nNibble][(Good >> (4*nNibble)) & 15];
+			nRet ^= Tables[1][col][nNibble][(Bad >> (4*nNibble)) & 15];
+		}
+		return nRet;
+	}
 }
 
-CGameField NewField( int player_to_move )
+template<typename TGeometry>
+TGameField<TGeometry> NewField( int player_to_move )
 {
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
 	static_assert(HEIGHT % 2 == 0, "");
-	CGameField Ret = {};
+	TGameField<TGeometry> Ret = {};
 	Ret._player_to_move = player_to_move;
-	for (int i = 0; i < START_LIVES; ++i)
+	for (int i = 0; i < TGeometry::START_LIVES; ++i)
 	{
 		FieldSquare EmptySquare = { -1, -1 };
 		do {
@@ -37,9 +90,12 @@ CGameField NewField( int player_to_move )
 	return Ret;
 }
 
-CGameField NextFieldSlow( const CGameField& Field )
+template<typename TGeometry>
+TGameField<TGeometry> NextFieldSlow( const TGameField<TGeometry>& Field )
 {
-	CGameField Ret = {};
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
+	TGameField<TGeometry> Ret = {};
 	int total[3] = {}; // For win conditions
 
 	for ( int row = 0; row < HEIGHT; ++row ) for ( int col = 0; col < WIDTH; ++col )
@@ -80,18 +136,21 @@ CGameField NextFieldSlow( const CGameField& Field )
 	{
 		// Win conditions
 		if ( total[0] == 0 && total[2] != 0 )
-			Ret._winner = CGameField::POSITIVE;
+			Ret._winner = TGameField<TGeometry>::POSITIVE;
 		else if ( total[2] == 0 && total[0] != 0 )
-			Ret._winner = CGameField::NEGATIVE;
+			Ret._winner = TGameField<TGeometry>::NEGATIVE;
 		else if ( total[0] == 0 || Ret._time >= MAX_ROUNDS )
-			Ret._winner = CGameField::DRAW;
+			Ret._winner = TGameField<TGeometry>::DRAW;
 	}
 	return Ret;
 }
 
-CGameField NextFieldFast( const CGameField& Field ) // Heavily optimized version of NextFieldSlow
+template<typename TGeometry>
+TGameField<TGeometry> NextFieldFast( const TGameField<TGeometry>& Field ) // Heavily optimized version of NextFieldSlow
 {
-	CGameField Ret;
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
+	TGameField<TGeometry> Ret;
 	int nGood = 0;
 	int nBad = 0;
 
@@ -178,17 +237,18 @@ CGameField NextFieldFast( const CGameField& Field ) // Heavily optimized version
 	{
 		// Win conditions
 		if ( nBad == 0 && nGood != 0 )
-			Ret._winner = CGameField::POSITIVE;
+			Ret._winner = TGameField<TGeometry>::POSITIVE;
 		else if ( nGood == 0 && nBad != 0 )
-			Ret._winner = CGameField::NEGATIVE;
+			Ret._winner = TGameField<TGeometry>::NEGATIVE;
 		else if ( nBad == 0 || Ret._time >= MAX_ROUNDS )
-			Ret._winner = CGameField::DRAW;
+			Ret._winner = TGameField<TGeometry>::DRAW;
 	}
 	return Ret;
 }
-CGameField NextFieldSuperFast( const CGameField& Field )
+namespace
 {
-	auto GetNeighborsAt = []( const std::array<COLMASK, WIDTH>& BitMask, int col )
+	template<typename COLMASK, size_t WIDTH>
+	std::array<COLMASK, 8> GetNeighborsAt( const std::array<COLMASK, WIDTH>& BitMask, int col )
 	{
 		std::array<COLMASK, 8> Ret = {};
 		Ret[0] = BitMask[col] << 1;
@@ -199,22 +259,18 @@ CGameField NextFieldSuperFast( const CGameField& Field )
 			Ret[3] = BitMask[col-1] << 1;
 			Ret[4] = BitMask[col-1] >> 1;
 		}
-		if ( col < WIDTH - 1 )
+		if ( col + 1 < int( WIDTH ) )
 		{
 			Ret[5] = BitMask[col+1];
 			Ret[6] = BitMask[col+1] << 1;
 			Ret[7] = BitMask[col+1] >> 1;
 		}
 		return Ret;
-	};
-
-	CGameField Ret;
-
-	std::array<COLMASK, WIDTH> Alive;
-	for ( int col = 0; col < WIDTH; ++col )
-		Alive[col] = Field._GoodBitMask[col] | Field._BadBitMask[col];
+	}
 
-	for ( int col = 0; col < WIDTH; ++col )
+	// Column col of NextFieldSuperFast. Alive must hold Good | Bad of Field for every column
+	template<typename TGeometry, typename COLMASK = typename TGeometry::COLMASK>
+	inline void NextColumn( const TGameField<TGeometry>& Field, const std::array<COLMASK, TGeometry::WIDTH>& Alive, int col, COLMASK& RetGood, COLMASK& RetBad )
 	{
 		COLMASK TooManyNeighbors = 0;
 		COLMASK EnoughNeighbors = 0;
@@ -239,75 +295,859 @@ CGameField NextFieldSuperFast( const CGameField& Field )
 				Good1 ^= x;
 			}
 		}
-		Ret._GoodBitMask[col] = EnoughNeighbors & ~TooManyNeighbors & ~Field._BadBitMask[col] & (GoodDominates | Self);
-		Ret._BadBitMask[col] = EnoughNeighbors & ~TooManyNeighbors & ~Field._GoodBitMask[col] & (~GoodDominates | Self);
+		RetGood = EnoughNeighbors & ~TooManyNeighbors & ~Field._BadBitMask[col] & (GoodDominates | Self);
+		RetBad = EnoughNeighbors & ~TooManyNeighbors & ~Field._GoodBitMask[col] & (~GoodDominates | Self);
+	}
+
+	template<typename TGeometry>
+	void DecideWinner( TGameField<TGeometry>& Ret ) // Needs _nGood, _nBad and _time of Ret
+	{
+		using TField = TGameField<TGeometry>;
+		Ret._winner = TField::UNDETERMINED;
+		{
+			// Win conditions
+			if ( Ret._nBad == 0 && Ret._nGood != 0 )
+				Ret._winner = TField::POSITIVE;
+			else if ( Ret._nGood == 0 && Ret._nBad != 0 )
+				Ret._winner = TField::NEGATIVE;
+			else if ( Ret._nBad == 0 || Ret._time >= MAX_ROUNDS )
+				Ret._winner = TField::DRAW;
+		}
+	}
+	template<typename TGeometry>
+	void AddCounts( TGameField<TGeometry>& Ret, int col, int nSign ) // Adds (or removes) column col to the live counts and _nLiveCols
+	{
+		Ret._nGood += nSign * PopCount( Ret._GoodBitMask[col] );
+		Ret._nBad += nSign * PopCount( Ret._BadBitMask[col] );
+		if ( nSign < 0 )
+			Ret._nLiveCols &= ~(1u << col);
+		else if ( Ret._GoodBitMask[col] | Ret._BadBitMask[col] )
+			Ret._nLiveCols |= 1u << col;
 	}
+}
+
+template<typename TGeometry>
+TGameField<TGeometry> NextFieldSuperFast( const TGameField<TGeometry>& Field )
+{
+	constexpr int WIDTH = TGeometry::WIDTH;
+	using COLMASK = typename TGeometry::COLMASK;
+	TGameField<TGeometry> Ret;
 
-	bool bAnyGood = false;
-	bool bAnyBad = false;
+	std::array<COLMASK, WIDTH> Alive;
+	for ( int col = 0; col < WIDTH; ++col )
+		Alive[col] = Field._GoodBitMask[col] | Field._BadBitMask[col];
+
+	const uint32_t nActiveCols = Field.GetActiveCols(); // The other columns stay empty
 	for ( int col = 0; col < WIDTH; ++col )
 	{
-		bAnyGood = bAnyGood || bool(Ret._GoodBitMask[col]);
-		bAnyBad = bAnyBad || bool(Ret._BadBitMask[col]);
+		if ( !((nActiveCols >> col) & 1) )
+			continue;
+		NextColumn( Field, Alive, col, Ret._GoodBitMask[col], Ret._BadBitMask[col] );
+		AddCounts( Ret, col, 1 );
 	}
 
 	Ret._time = Field._time + 1;
 	Ret._player_to_move = -Field._player_to_move;
+	Ret.UpdateHash();
+	DecideWinner( Ret );
+	return Ret;
+}
+
+// Lookup-table kernel: one pair of lookups per 2 output squares, indexed by the 3 columns x 4 rows around them
+namespace
+{
+	constexpr int LOOKUP_BITS = 12; // Bit 4*c + k: column col-1+c, row r-1+k
+
+	struct SLookupTables
 	{
-		// Win conditions
-		if ( !bAnyBad && bAnyGood )
-			Ret._winner = CGameField::POSITIVE;
-		else if ( !bAnyGood && bAnyBad )
-			Ret._winner = CGameField::NEGATIVE;
-		else if ( !bAnyBad || Ret._time >= MAX_ROUNDS )
-			Ret._winner = CGameField::DRAW;
+		std::array<uint8_t, 1 << LOOKUP_BITS> _Alive; // Bits 0-1: alive next (rows r, r+1), bits 2-3: born
+		std::array<uint8_t, 1 << LOOKUP_BITS> _GoodDominates; // Bits 0-1: at least 2 good neighbors
+	};
+
+	const SLookupTables& GetLookupTables()
+	{
+		static const SLookupTables Ret = []() {
+			SLookupTables Tables = {};
+			for ( int nIndex = 0; nIndex < (1 << LOOKUP_BITS); ++nIndex )
+			{
+				for ( int nOut = 0; nOut < 2; ++nOut )
+				{
+					const int k = nOut + 1;
+					int nNeighbors = 0;
+					for ( int c = 0; c < 3; ++c ) for ( int kk = k - 1; kk <= k + 1; ++kk )
+						if ( (c != 1 || kk != k) && ((nIndex >> (4*c + kk)) & 1) )
+							++nNeighbors;
+					const bool bSelf = (nIndex >> (4 + k)) & 1;
+					if ( bSelf ? (nNeighbors == 2 || nNeighbors == 3) : nNeighbors == 3 )
+						Tables._Alive[nIndex] |= 1 << nOut;
+					if ( !bSelf && nNeighbors == 3 )
+						Tables._Alive[nIndex] |= 4 << nOut;
+					if ( nNeighbors >= 2 ) // Same neighborhood, read as good squares
+						Tables._GoodDominates[nIndex] |= 1 << nOut;
+				}
+			}
+			return Tables;
+		}();
+		return Ret;
+	}
+
+	inline int GetLookupIndex( uint32_t Left, uint32_t Center, uint32_t Right, int row ) // Columns shifted up by 1, so row -1 is bit 0
+	{
+		return ((Left >> row) & 15) | (((Center >> row) & 15) << 4) | (((Right >> row) & 15) << 8);
 	}
+}
+
+template<typename TGeometry>
+TGameField<TGeometry> NextFieldLookup( const TGameField<TGeometry>& Field )
+{
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
+	static_assert( HEIGHT % 2 == 0 && HEIGHT < 31, "Lookups emit 2 rows at a time, from 32-bit columns" );
+	const SLookupTables& Tables = GetLookupTables();
+	TGameField<TGeometry> Ret;
+
+	std::array<uint32_t, WIDTH+2> Alive = {}; // Column col is at col+1
+	std::array<uint32_t, WIDTH+2> Good = {};
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		Alive[col+1] = uint32_t( Field._GoodBitMask[col] | Field._BadBitMask[col] ) << 1;
+		Good[col+1] = uint32_t( Field._GoodBitMask[col] ) << 1;
+	}
+
+	const uint32_t nActiveCols = Field.GetActiveCols();
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		if ( !((nActiveCols >> col) & 1) )
+			continue;
+		uint32_t RetGood = 0;
+		uint32_t RetAlive = 0;
+		for ( int row = 0; row < HEIGHT; row += 2 )
+		{
+			const int nAlive = Tables._Alive[GetLookupIndex( Alive[col], Alive[col+1], Alive[col+2], row )];
+			const int nGoodDominates = Tables._GoodDominates[GetLookupIndex( Good[col], Good[col+1], Good[col+2], row )];
+			const int nSelfGood = (Good[col+1] >> (row + 1)) & 3;
+			const int nBorn = nAlive >> 2;
+			RetAlive |= uint32_t( nAlive & 3 ) << row;
+			RetGood |= uint32_t( nAlive & ((nBorn & nGoodDominates) | (~nBorn & nSelfGood)) & 3 ) << row;
+		}
+		Ret._GoodBitMask[col] = typename TGeometry::COLMASK( RetGood );
+		Ret._BadBitMask[col] = typename TGeometry::COLMASK( RetAlive & ~RetGood );
+		AddCounts( Ret, col, 1 );
+	}
+
+	Ret._time = Field._time + 1;
+	Ret._player_to_move = -Field._player_to_move;
+	Ret.UpdateHash();
+	DecideWinner( Ret );
 	return Ret;
 }
 
-CGameField NextField( const CGameField& Field )
+// SWAR kernel for 8-bit columns: byte b of word w is column 8*w+b, so whole words step together
+template<typename TGeometry>
+TGameField<TGeometry> NextFieldSWAR( const TGameField<TGeometry>& Field )
 {
-	return NextFieldSuperFast( Field );
+	static_assert( sizeof( typename TGeometry::COLMASK ) == 1, "NextFieldSWAR needs 8-bit columns" );
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int WORDS = (WIDTH + 7) / 8;
+	constexpr uint64_t ROW_MASK = 0x0101010101010101ull * ((1u << TGeometry::HEIGHT) - 1); // Rows on the board, in every byte
+	using TWords = std::array<uint64_t, WORDS>;
+
+	TWords Good = {}, Bad = {};
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		Good[col / 8] |= uint64_t( Field._GoodBitMask[col] ) << (8 * (col % 8));
+		Bad[col / 8] |= uint64_t( Field._BadBitMask[col] ) << (8 * (col % 8));
+	}
+	auto Left = []( const TWords& x, int w ) -> uint64_t { return (x[w] << 8) | (w > 0 ? x[w-1] >> 56 : 0); }; // Column col-1
+	auto Right = []( const TWords& x, int w ) -> uint64_t { return (x[w] >> 8) | (w < WORDS-1 ? x[w+1] << 56 : 0); }; // Column col+1
+	auto Up = []( uint64_t x ) -> uint64_t { return (x << 1) & 0xFEFEFEFEFEFEFEFEull & ROW_MASK; };
+	auto Down = []( uint64_t x ) -> uint64_t { return (x >> 1) & 0x7F7F7F7F7F7F7F7Full; };
+
+	TWords Alive;
+	for ( int w = 0; w < WORDS; ++w )
+		Alive[w] = Good[w] | Bad[w];
+
+	TGameField<TGeometry> Ret;
+	for ( int w = 0; w < WORDS; ++w )
+	{
+		const uint64_t Self = Alive[w];
+		const uint64_t AliveLeft = Left( Alive, w ), AliveRight = Right( Alive, w );
+		const uint64_t GoodLeft = Left( Good, w ), GoodRight = Right( Good, w );
+
+		uint64_t TooManyNeighbors = 0, EnoughNeighbors = 0, Sum1 = 0, Sum2 = 0;
+		for ( uint64_t x : { Up( Self ), Down( Self ), AliveLeft, Up( AliveLeft ), Down( AliveLeft ), AliveRight, Up( AliveRight ), Down( AliveRight ) } )
+		{
+			TooManyNeighbors |= Sum1 & Sum2 & x;
+			Sum2 ^= Sum1 & x;
+			Sum1 ^= x;
+			EnoughNeighbors |= Sum2 & (Sum1 | Self);
+		}
+		uint64_t GoodDominates = 0, Good1 = 0;
+		for ( uint64_t x : { Up( Good[w] ), Down( Good[w] ), GoodLeft, Up( GoodLeft ), Down( GoodLeft ), GoodRight, Up( GoodRight ), Down( GoodRight ) } )
+		{
+			GoodDominates |= Good1 & x;
+			Good1 ^= x;
+		}
+		const uint64_t Survivors = EnoughNeighbors & ~TooManyNeighbors;
+		const uint64_t RetGood = Survivors & ~Bad[w] & (GoodDominates | Self);
+		const uint64_t RetBad = Survivors & ~Good[w] & (~GoodDominates | Self);
+		for ( int col = 8 * w; col < std::min( WIDTH, 8 * w + 8 ); ++col )
+		{
+			Ret._GoodBitMask[col] = uint8_t( RetGood >> (8 * (col % 8)) );
+			Ret._BadBitMask[col] = uint8_t( RetBad >> (8 * (col % 8)) );
+			AddCounts( Ret, col, 1 );
+		}
+	}
+
+	Ret._time = Field._time + 1;
+	Ret._player_to_move = -Field._player_to_move;
+	Ret.UpdateHash();
+	DecideWinner( Ret );
+	return Ret;
 }
 
-// Symmetries
-CGameField HorizontalFlip( const CGameField& Field )
+namespace
+{
+	template<typename TGeometry, bool SMALL_COLUMNS = sizeof( typename TGeometry::COLMASK ) == 1>
+	struct SDefaultKernel
+	{
+#ifdef LOOKUP_KERNEL
+		static constexpr TNextFieldKernel<TGeometry> KERNEL = &NextFieldLookup<TGeometry>;
+#else
+		static constexpr TNextFieldKernel<TGeometry> KERNEL = &NextFieldSuperFast<TGeometry>;
+#endif
+	};
+	template<typename TGeometry>
+	struct SDefaultKernel<TGeometry, true>
+	{
+		static constexpr TNextFieldKernel<TGeometry> KERNEL = &NextFieldSWAR<TGeometry>;
+	};
+
+	template<typename TGeometry>
+	TNextFieldKernel<TGeometry> s_pNextFieldKernel = SDefaultKernel<TGeometry>::KERNEL; // Constant initialized
+}
+template<typename TGeometry>
+void SetNextFieldKernel( TNextFieldKernel<TGeometry> pKernel )
+{
+	s_pNextFieldKernel<TGeometry> = pKernel;
+}
+template<typename TGeometry>
+TNextFieldKernel<TGeometry> GetNextFieldKernel()
+{
+	return s_pNextFieldKernel<TGeometry>;
+}
+
+template<typename TGeometry>
+TGameField<TGeometry> NextField( const TGameField<TGeometry>& Field )
+{
+	return s_pNextFieldKernel<TGeometry>( Field );
+}
+
+template<typename TGeometry>
+size_t NextFieldN( const TGameField<TGeometry>& Field, size_t K, TGameField<TGeometry>* pFields, int* pGood, int* pBad )
+{
+	using TField = TGameField<TGeometry>;
+	constexpr int WIDTH = TGeometry::WIDTH;
+	pFields[0] = Field;
+	pGood[0] = Field._nGood;
+	pBad[0] = Field._nBad;
+
+#ifdef CLUSTER_LOOKAHEAD
+	const size_t nClustered = std::min<size_t>( K - 1, MAX_CLUSTER_GENERATIONS ); // Bit masks of pFields[1] to pFields[nClustered] come up front
+	if ( nClustered > 0 )
+		NextFieldsClustered( Field, nClustered, pFields + 1 );
+#else
+	const size_t nClustered = 0;
+#endif
+
+	size_t n = 1;
+	size_t nPeriod = 0; // Once the boards repeat, the next board is the one nPeriod generations back
+	for ( ; n < K && pFields[n-1]._winner == TField::UNDETERMINED; ++n )
+	{
+		const TField& Prev = pFields[n-1];
+		for ( size_t p = 1; nPeriod == 0 && p <= 2 && p < n; ++p )
+		{
+			if ( Prev.IsSameField( pFields[n-1-p] ) )
+				nPeriod = p;
+		}
+		if ( nPeriod != 0 )
+		{
+			TField& Ret = pFields[n] = pFields[n-nPeriod]; // A pass successor, with its hash and counts
+			Ret._time = Prev._time + 1;
+			Ret._player_to_move = -Prev._player_to_move;
+			DecideWinner( Ret );
+			pGood[n] = Ret._nGood;
+			pBad[n] = Ret._nBad;
+			continue;
+		}
+		TField& Ret = pFields[n];
+		if ( n <= nClustered )
+			Ret.UpdateCounts();
+		else
+		{
+			Ret = TField();
+			std::array<typename TGeometry::COLMASK, WIDTH> Alive;
+			for ( int col = 0; col < WIDTH; ++col )
+				Alive[col] = Prev._GoodBitMask[col] | Prev._BadBitMask[col];
+
+			const uint32_t nActiveCols = Prev.GetActiveCols();
+			for ( int col = 0; col < WIDTH; ++col )
+			{
+				if ( !((nActiveCols >> col) & 1) )
+					continue;
+				NextColumn( Prev, Alive, col, Ret._GoodBitMask[col], Ret._BadBitMask[col] );
+				AddCounts( Ret, col, 1 );
+			}
+		}
+		pGood[n] = Ret._nGood;
+		pBad[n] = Ret._nBad;
+
+		Ret._time = Prev._time + 1;
+		Ret._player_to_move = -Prev._player_to_move;
+		Ret.UpdateHash();
+		DecideWinner( Ret );
+	}
+	for ( size_t k = n; k < K; ++k )
+	{
+		pGood[k] = pGood[n-1];
+		pBad[k] = pBad[n-1];
+	}
+	return n;
+}
+
+// Batched stepping: Same carry-save counting as NextFieldSuperFast, but lane i of every register holds a column of board i
+namespace
+{
+	template<typename COLMASK>
+	constexpr size_t GetBatchLanes() { return 64 / sizeof( COLMASK ); } // One AVX-512 register of columns
+
+	template<typename COLMASK>
+	struct SLanes // Portable version, any SIMD type below has the same interface
+	{
+		static constexpr size_t BATCH_LANES = GetBatchLanes<COLMASK>();
+		std::array<COLMASK, BATCH_LANES> _x;
+		template<typename Op>
+		SLanes Apply( SLanes o, Op op ) const
+		{
+			SLanes Ret;
+			for ( size_t i = 0; i < BATCH_LANES; ++i )
+				Ret._x[i] = COLMASK( op( _x[i], o._x[i] ) );
+			return Ret;
+		}
+		static SLanes Zero() { return { {} }; }
+		static SLanes Load( const COLMASK* p ) { SLanes Ret; std::copy( p, p + BATCH_LANES, Ret._x.begin() ); return Ret; }
+		void Store( COLMASK* p ) const { std::copy( _x.begin(), _x.end(), p ); }
+		SLanes operator&( SLanes o ) const { return Apply( o, []( COLMASK a, COLMASK b ) { return a & b; } ); }
+		SLanes operator|( SLanes o ) const { return Apply( o, []( COLMASK a, COLMASK b ) { return a | b; } ); }
+		SLanes operator^( SLanes o ) const { return Apply( o, []( COLMASK a, COLMASK b ) { return a ^ b; } ); }
+		SLanes AndNot( SLanes o ) const { return Apply( o, []( COLMASK a, COLMASK b ) { return a & ~b; } ); }
+		SLanes Up() const { return Apply( *this, []( COLMASK a, COLMASK ) { return a << 1; } ); }
+		SLanes Down() const { return Apply( *this, []( COLMASK a, COLMASK ) { return a >> 1; } ); }
+	};
+
+#ifdef CPU_DISPATCH
+	// Registers of one instruction set. Shifts move every 16-bit lane, 8-bit columns are masked afterwards.
+	// Results go through references: vectors passed by value outside their target change the ABI (-Wpsabi)
+	struct SSSE2Registers
+	{
+		using R = __m128i;
+		CPU_TARGET( "sse2" ) static void Zero( R& Ret ) { Ret = _mm_setzero_si128(); }
+		CPU_TARGET( "sse2" ) static void Load( R& Ret, const void* p ) { Ret = _mm_loadu_si128( static_cast<const R*>(p) ); }
+		CPU_TARGET( "sse2" ) static void Store( void* p, const R& x ) { _mm_storeu_si128( static_cast<R*>(p), x ); }
+		CPU_TARGET( "sse2" ) static void And( R& Ret, const R& a, const R& b ) { Ret = _mm_and_si128( a, b ); }
+		CPU_TARGET( "sse2" ) static void Or( R& Ret, const R& a, const R& b ) { Ret = _mm_or_si128( a, b ); }
+		CPU_TARGET( "sse2" ) static void Xor( R& Ret, const R& a, const R& b ) { Ret = _mm_xor_si128( a, b ); }
+		CPU_TARGET( "sse2" ) static void AndNot( R& Ret, const R& a, const R& b ) { Ret = _mm_andnot_si128( b, a ); } // a & ~b
+		CPU_TARGET( "sse2" ) static void Up( R& Ret, const R& x, char nMask ) { Ret = _mm_and_si128( _mm_slli_epi16( x, 1 ), _mm_set1_epi8( nMask ) ); }
+		CPU_TARGET( "sse2" ) static void Down( R& Ret, const R& x, char nMask ) { Ret = _mm_and_si128( _mm_srli_epi16( x, 1 ), _mm_set1_epi8( nMask ) ); }
+	};
+	struct SAVX2Registers
+	{
+		using R = __m256i;
+		CPU_TARGET( "avx2" ) static void Zero( R& Ret ) { Ret = _mm256_setzero_si256(); }
+		CPU_TARGET( "avx2" ) static void Load( R& Ret, const void* p ) { Ret = _mm256_loadu_si256( static_cast<const R*>(p) ); }
+		CPU_TARGET( "avx2" ) static void Store( void* p, const R& x ) { _mm256_storeu_si256( static_cast<R*>(p), x ); }
+		CPU_TARGET( "avx2" ) static void And( R& Ret, const R& a, const R& b ) { Ret = _mm256_and_si256( a, b ); }
+		CPU_TARGET( "avx2" ) static void Or( R& Ret, const R& a, const R& b ) { Ret = _mm256_or_si256( a, b ); }
+		CPU_TARGET( "avx2" ) static void Xor( R& Ret, const R& a, const R& b ) { Ret = _mm256_xor_si256( a, b ); }
+		CPU_TARGET( "avx2" ) static void AndNot( R& Ret, const R& a, const R& b ) { Ret = _mm256_andnot_si256( b, a ); }
+		CPU_TARGET( "avx2" ) static void Up( R& Ret, const R& x, char nMask ) { Ret = _mm256_and_si256( _mm256_slli_epi16( x, 1 ), _mm256_set1_epi8( nMask ) ); }
+		CPU_TARGET( "avx2" ) static void Down( R& Ret, const R& x, char nMask ) { Ret = _mm256_and_si256( _mm256_srli_epi16( x, 1 ), _mm256_set1_epi8( nMask ) ); }
+	};
+	struct SAVX512Registers
+	{
+		using R = __m512i;
+		CPU_TARGET( "avx512f,avx512bw" ) static void Zero( R& Ret ) { Ret = _mm512_setzero_si512(); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void Load( R& Ret, const void* p ) { Ret = _mm512_loadu_si512( p ); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void Store( void* p, const R& x ) { _mm512_storeu_si512( p, x ); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void And( R& Ret, const R& a, const R& b ) { Ret = _mm512_and_si512( a, b ); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void Or( R& Ret, const R& a, const R& b ) { Ret = _mm512_or_si512( a, b ); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void Xor( R& Ret, const R& a, const R& b ) { Ret = _mm512_xor_si512( a, b ); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void AndNot( R& Ret, const R& a, const R& b ) { Ret = _mm512_and_si512( a, _mm512_xor_si512( b, _mm512_set1_epi32( -1 ) ) ); } // _mm512_andnot_si512 trips -Wuninitialized in g++ 12
+		CPU_TARGET( "avx512f,avx512bw" ) static void Up( R& Ret, const R& x, char nMask ) { Ret = _mm512_and_si512( _mm512_slli_epi16( x, 1 ), _mm512_set1_epi8( nMask ) ); }
+		CPU_TARGET( "avx512f,avx512bw" ) static void Down( R& Ret, const R& x, char nMask ) { Ret = _mm512_and_si512( _mm512_srli_epi16( x, 1 ), _mm512_set1_epi8( nMask ) ); }
+	};
+
+	// The SLanes interface on as many registers as the batch needs
+	template<typename TRegisters, typename COLMASK>
+	struct TSimdLanes
+	{
+		using R = typename TRegisters::R;
+		static constexpr size_t REGISTERS = GetBatchLanes<COLMASK>() * sizeof( COLMASK ) / sizeof( R );
+		static constexpr char UP_MASK = sizeof( COLMASK ) == 1 ? char( 0xFE ) : char( 0xFF );
+		static constexpr char DOWN_MASK = sizeof( COLMASK ) == 1 ? char( 0x7F ) : char( 0xFF );
+		R _x[REGISTERS];
+		template<typename Op>
+		TSimdLanes Apply( const TSimdLanes& o, Op op ) const
+		{
+			TSimdLanes Ret;
+			for ( size_t i = 0; i < REGISTERS; ++i )
+				op( Ret._x[i], _x[i], o._x[i] );
+			return Ret;
+		}
+		static TSimdLanes Zero() { TSimdLanes Ret; for ( R& x : Ret._x ) TRegisters::Zero( x ); return Ret; }
+		static TSimdLanes Load( const COLMASK* p ) { TSimdLanes Ret; for ( size_t i = 0; i < REGISTERS; ++i ) TRegisters::Load( Ret._x[i], p + i * sizeof( R ) / sizeof( COLMASK ) ); return Ret; }
+		void Store( COLMASK* p ) const { for ( size_t i = 0; i < REGISTERS; ++i ) TRegisters::Store( p + i * sizeof( R ) / sizeof( COLMASK ), _x[i] ); }
+		TSimdLanes operator&( const TSimdLanes& o ) const { return Apply( o, []( R& Ret, const R& a, const R& b ) { TRegisters::And( Ret, a, b ); } ); }
+		TSimdLanes operator|( const TSimdLanes& o ) const { return Apply( o, []( R& Ret, const R& a, const R& b ) { TRegisters::Or( Ret, a, b ); } ); }
+		TSimdLanes operator^( const TSimdLanes& o ) const { return Apply( o, []( R& Ret, const R& a, const R& b ) { TRegisters::Xor( Ret, a, b ); } ); }
+		TSimdLanes AndNot( const TSimdLanes& o ) const { return Apply( o, []( R& Ret, const R& a, const R& b ) { TRegisters::AndNot( Ret, a, b ); } ); }
+		TSimdLanes Up() const { TSimdLanes Ret; for ( size_t i = 0; i < REGISTERS; ++i ) TRegisters::Up( Ret._x[i], _x[i], UP_MASK ); return Ret; }
+		TSimdLanes Down() const { TSimdLanes Ret; for ( size_t i = 0; i < REGISTERS; ++i ) TRegisters::Down( Ret._x[i], _x[i], DOWN_MASK ); return Ret; }
+	};
+#endif
+
+	template<typename TGeometry>
+	using TLaneColumns = std::array<std::array<typename TGeometry::COLMASK, GetBatchLanes<typename TGeometry::COLMASK>()>, TGeometry::WIDTH>;
+
+	template<typename TGeometry, typename TLanes>
+	void NextLanes( const TLaneColumns<TGeometry>& Good, const TLaneColumns<TGeometry>& Bad, TLaneColumns<TGeometry>& RetGood, TLaneColumns<TGeometry>& RetBad )
+	{
+		constexpr int WIDTH = TGeometry::WIDTH;
+		using SLanes = TLanes;
+		auto GetNeighborsAt = []( const std::array<SLanes, WIDTH>& BitMask, int col )
+		{
+			std::array<SLanes, 8> Ret;
+			Ret.fill( SLanes::Zero() );
+			Ret[0] = BitMask[col].Up();
+			Ret[1] = BitMask[col].Down();
+			if ( col > 0 )
+			{
+				Ret[2] = BitMask[col-1];
+				Ret[3] = BitMask[col-1].Up();
+				Ret[4] = BitMask[col-1].Down();
+			}
+			if ( col < WIDTH - 1 )
+			{
+				Ret[5] = BitMask[col+1];
+				Ret[6] = BitMask[col+1].Up();
+				Ret[7] = BitMask[col+1].Down();
+			}
+			return Ret;
+		};
+
+		std::array<SLanes, WIDTH> GoodLanes, BadLanes, Alive;
+		for ( int col = 0; col < WIDTH; ++col )
+		{
+			GoodLanes[col] = SLanes::Load( Good[col].data() );
+			BadLanes[col] = SLanes::Load( Bad[col].data() );
+			Alive[col] = GoodLanes[col] | BadLanes[col];
+		}
+
+		for ( int col = 0; col < WIDTH; ++col )
+		{
+			SLanes TooManyNeighbors = SLanes::Zero();
+			SLanes EnoughNeighbors = SLanes::Zero();
+			const SLanes Self = Alive[col];
+			{
+				SLanes Sum1 = SLanes::Zero();
+				SLanes Sum2 = SLanes::Zero();
+				for ( SLanes x : GetNeighborsAt( Alive, col ) )
+				{
+					TooManyNeighbors = TooManyNeighbors | (Sum1 & Sum2 & x);
+					Sum2 = Sum2 ^ (Sum1 & x);
+					Sum1 = Sum1 ^ x;
+					EnoughNeighbors = EnoughNeighbors | (Sum2 & (Sum1 | Self));
+				}
+			}
+			SLanes GoodDominates = SLanes::Zero();
+			{
+				SLanes Good1 = SLanes::Zero();
+				for ( SLanes x : GetNeighborsAt( GoodLanes, col ) )
+				{
+					GoodDominates = GoodDominates | (Good1 & x);
+					Good1 = Good1 ^ x;
+				}
+			}
+			const SLanes Survivors = EnoughNeighbors.AndNot( TooManyNeighbors );
+			(Survivors & (GoodDominates | Self)).AndNot( BadLanes[col] ).Store( RetGood[col].data() );
+			Survivors.AndNot( GoodLanes[col] ).AndNot( GoodDominates.AndNot( Self ) ).Store( RetBad[col].data() ); // (~GoodDominates | Self)
+		}
+	}
+
+	template<typename TGeometry, typename TLanes>
+	void StepBatch( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N )
+	{
+		constexpr int WIDTH = TGeometry::WIDTH;
+		constexpr size_t BATCH_LANES = GetBatchLanes<typename TGeometry::COLMASK>();
+		TLaneColumns<TGeometry> Good, Bad, RetGood, RetBad;
+		for ( size_t nFirst = 0; nFirst < N; nFirst += BATCH_LANES )
+		{
+			const size_t nLanes = std::min( BATCH_LANES, N - nFirst );
+			for ( int col = 0; col < WIDTH; ++col )
+			{
+				Good[col].fill( 0 );
+				Bad[col].fill( 0 );
+				for ( size_t i = 0; i < nLanes; ++i )
+				{
+					Good[col][i] = pFields[nFirst+i]._GoodBitMask[col];
+					Bad[col][i] = pFields[nFirst+i]._BadBitMask[col];
+				}
+			}
+
+			NextLanes<TGeometry, TLanes>( Good, Bad, RetGood, RetBad );
+
+			for ( size_t i = 0; i < nLanes; ++i )
+			{
+				const TGameField<TGeometry>& Field = pFields[nFirst+i];
+				TGameField<TGeometry>& Ret = pOut[nFirst+i];
+				Ret._nGood = Ret._nBad = 0;
+				Ret._nLiveCols = 0;
+				for ( int col = 0; col < WIDTH; ++col )
+				{
+					Ret._GoodBitMask[col] = RetGood[col][i];
+					Ret._BadBitMask[col] = RetBad[col][i];
+					AddCounts( Ret, col, 1 );
+				}
+				Ret._last_killed = DEAD;
+				Ret._time = Field._time + 1;
+				Ret._player_to_move = -Field._player_to_move;
+				Ret.UpdateHash();
+				DecideWinner( Ret );
+			}
+		}
+	}
+
+	template<typename TGeometry>
+	using TStepBatch = void (*)( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N );
+#ifdef CPU_DISPATCH
+	template<typename TGeometry>
+	CPU_TARGET( "sse2" ) void StepBatchSSE2( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N )
+	{
+		StepBatch<TGeometry, TSimdLanes<SSSE2Registers, typename TGeometry::COLMASK>>( pFields, pOut, N );
+	}
+	template<typename TGeometry>
+	CPU_TARGET( "avx2" ) void StepBatchAVX2( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N )
+	{
+		StepBatch<TGeometry, TSimdLanes<SAVX2Registers, typename TGeometry::COLMASK>>( pFields, pOut, N );
+	}
+	template<typename TGeometry>
+	CPU_TARGET( "avx512f,avx512bw" ) void StepBatchAVX512( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N )
+	{
+		StepBatch<TGeometry, TSimdLanes<SAVX512Registers, typename TGeometry::COLMASK>>( pFields, pOut, N );
+	}
+#endif
+	template<typename TGeometry>
+	TStepBatch<TGeometry> GetStepBatch()
+	{
+		switch ( GetKernelLevel( KERNEL_BATCH_STEP ) )
+		{
+#ifdef CPU_DISPATCH
+		case CPU_AVX512: return &StepBatchAVX512<TGeometry>;
+		case CPU_AVX2: return &StepBatchAVX2<TGeometry>;
+		case CPU_SSE2: return &StepBatchSSE2<TGeometry>;
+#endif
+		default: return &StepBatch<TGeometry, SLanes<typename TGeometry::COLMASK>>;
+		}
+	}
+}
+
+template<typename TGeometry>
+void NextFieldBatch( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N )
+{
+	GetStepBatch<TGeometry>()( pFields, pOut, N );
+}
+template<typename TGeometry>
+std::vector<TGameField<TGeometry>> NextFieldBatch( const std::vector<TGameField<TGeometry>>& Fields )
+{
+	std::vector<TGameField<TGeometry>> Ret( Fields.size() );
+	NextFieldBatch( Fields.data(), Ret.data(), Fields.size() );
+	return Ret;
+}
+
+// Single toggles: one sweep of neighbor-count bitplanes gives the next state of every square under any nearby toggle
+namespace
+{
+	using TCountPlanes = std::array<uint32_t, 4>; // Bit b of the number of live neighbors
+
+	template<typename TGeometry>
+	std::array<TCountPlanes, TGeometry::WIDTH> CountNeighbors( const std::array<typename TGeometry::COLMASK, TGeometry::WIDTH>& BitMask )
+	{
+		std::array<TCountPlanes, TGeometry::WIDTH> Ret = {};
+		for ( int col = 0; col < TGeometry::WIDTH; ++col )
+		{
+			for ( uint32_t x : GetNeighborsAt( BitMask, col ) )
+			{
+				for ( uint32_t& Plane : Ret[col] ) // Ripple carry, counts stay below 9
+				{
+					const uint32_t Carry = Plane & x;
+					Plane ^= x;
+					x = Carry;
+				}
+			}
+		}
+		return Ret;
+	}
+	inline uint32_t Equals( const TCountPlanes& Count, int n )
+	{
+		uint32_t Ret = ~0u;
+		for ( int b = 0; b < 4; ++b )
+			Ret &= ((n >> b) & 1) ? Count[b] : ~Count[b];
+		return Ret;
+	}
+	inline uint32_t AtLeast( const TCountPlanes& Count, int n )
+	{
+		uint32_t Ret = 0;
+		for ( ; n <= 8; ++n )
+			Ret |= Equals( Count, n );
+		return Ret;
+	}
+
+	template<int WIDTH>
+	struct SNextState
+	{
+		std::array<uint32_t, WIDTH> _Alive;
+		std::array<uint32_t, WIDTH> _Good;
+	};
+	template<int WIDTH>
+	struct STogglePlanes
+	{
+		std::array<SNextState<WIDTH>, 2> _Plus; // A neighbor born, [0] GOOD, [1] BAD
+		std::array<SNextState<WIDTH>, 2> _Minus; // A neighbor killed
+		std::array<uint32_t, WIDTH> _BirthSelf; // Alive if born here
+		SNextState<WIDTH> _KillSelf;
+	};
+
+	template<typename TGeometry>
+	STogglePlanes<TGeometry::WIDTH> GetTogglePlanes( const TGameField<TGeometry>& Field )
+	{
+		constexpr int WIDTH = TGeometry::WIDTH;
+		std::array<typename TGeometry::COLMASK, WIDTH> Alive;
+		for ( int col = 0; col < WIDTH; ++col )
+			Alive[col] = Field._GoodBitMask[col] | Field._BadBitMask[col];
+		const auto N = CountNeighbors<TGeometry>( Alive );
+		const auto G = CountNeighbors<TGeometry>( Field._GoodBitMask );
+
+		STogglePlanes<WIDTH> Ret;
+		for ( int col = 0; col < WIDTH; ++col )
+		{
+			const uint32_t Self = Alive[col];
+			const uint32_t Good = Field._GoodBitMask[col];
+			const uint32_t N2 = Equals( N[col], 2 ), N3 = Equals( N[col], 3 ), N4 = Equals( N[col], 4 );
+			const uint32_t Survive1or2 = Self & (Equals( N[col], 1 ) | N2);
+			const uint32_t Survive3or4 = Self & (N3 | N4);
+			const uint32_t G1 = AtLeast( G[col], 1 ), G2 = AtLeast( G[col], 2 ), G3 = AtLeast( G[col], 3 );
+
+			// With one more neighbor: alive needs 1 or 2 before, birth needs 2. Born good if the good neighbors become at least 2
+			for ( auto* pPlus : { &Ret._Plus[0], &Ret._Plus[1] } )
+				pPlus->_Alive[col] = Survive1or2 | (~Self & N2);
+			Ret._Plus[0]._Good[col] = (Good & Survive1or2) | (~Self & N2 & G1);
+			Ret._Plus[1]._Good[col] = (Good & Survive1or2) | (~Self & N2 & G2);
+			// With one neighbor less: alive needs 3 or 4 before, birth needs 4
+			for ( auto* pMinus : { &Ret._Minus[0], &Ret._Minus[1] } )
+				pMinus->_Alive[col] = Survive3or4 | (~Self & N4);
+			Ret._Minus[0]._Good[col] = (Good & Survive3or4) | (~Self & N4 & G3);
+			Ret._Minus[1]._Good[col] = (Good & Survive3or4) | (~Self & N4 & G2);
+
+			Ret._BirthSelf[col] = N2 | N3;
+			Ret._KillSelf._Alive[col] = N3;
+			Ret._KillSelf._Good[col] = N3 & G2;
+		}
+		return Ret;
+	}
+}
+template<typename TGeometry>
+std::vector<TToggleDelta<TGeometry>> GetSingleToggleDeltas( const TGameField<TGeometry>& Field, const TGameField<TGeometry>& PassField )
+{
+	constexpr int WIDTH = TGeometry::WIDTH;
+	using COLMASK = typename TGeometry::COLMASK;
+	const uint32_t ROWS = (1u << TGeometry::HEIGHT) - 1;
+	const STogglePlanes<WIDTH> Planes = GetTogglePlanes( Field );
+
+	std::vector<TToggleDelta<TGeometry>> Ret;
+	Ret.reserve( TGeometry::WIDTH * TGeometry::HEIGHT );
+	for ( bool bBirth : { true, false } )
+	{
+		for ( const FieldSquare& Square : GetAllFieldSquares<TGeometry>() )
+		{
+			const ELifeMode X = Field.GetSquare( Square );
+			if ( (X == DEAD) != bBirth )
+				continue;
+			const int row = Square.first;
+			const int col = Square.second;
+			const ELifeMode Colour = bBirth ? ELifeMode( Field._player_to_move ) : X;
+			const SNextState<WIDTH>& Near = bBirth ? Planes._Plus[Colour == GOOD ? 0 : 1] : Planes._Minus[Colour == GOOD ? 0 : 1];
+			const bool bColoured = Colour == GOOD || Colour == BAD; // SetSquare ignores a birth by any other player
+			const uint32_t Window = bColoured ? ((7u << row) >> 1) & ROWS : 0; // Rows row-1 to row+1
+			const uint32_t SelfBit = 1u << row;
+			const uint32_t SelfAlive = SelfBit & (bBirth ? Planes._BirthSelf[col] : Planes._KillSelf._Alive[col]);
+			const uint32_t SelfGood = bBirth ? (Colour == GOOD ? SelfAlive : 0) : SelfBit & Planes._KillSelf._Good[col];
+
+			TToggleDelta<TGeometry> Delta;
+			Delta._Move = TMovePart( Square, bBirth );
+			for ( int i = 0; i < 3; ++i )
+			{
+				const int c = col - 1 + i;
+				if ( c < 0 || c >= WIDTH )
+				{
+					Delta._GoodBitMask[i] = Delta._BadBitMask[i] = 0;
+					continue;
+				}
+				uint32_t Alive = ((PassField._GoodBitMask[c] | PassField._BadBitMask[c]) & ~Window) | (Near._Alive[c] & Window);
+				uint32_t Good = (PassField._GoodBitMask[c] & ~Window) | (Near._Good[c] & Window);
+				if ( c == col && bColoured )
+				{
+					Alive = (Alive & ~SelfBit) | SelfAlive;
+					Good = (Good & ~SelfBit) | SelfGood;
+				}
+				Delta._GoodBitMask[i] = COLMASK( Good );
+				Delta._BadBitMask[i] = COLMASK( Alive & ~Good );
+			}
+			Ret.push_back( Delta );
+		}
+	}
+	return Ret;
+}
+template<typename TGeometry>
+TGameField<TGeometry> TToggleDelta<TGeometry>::GetSuccessor( const TGameField<TGeometry>& PassField ) const
 {
-	CGameField Ret = Field;
-	for ( int col = 0; col < WIDTH/2; ++col )
+	TGameField<TGeometry> Ret = PassField;
+	for ( int i = 0; i < 3; ++i )
 	{
-		std::swap( Ret._GoodBitMask[col], Ret._GoodBitMask[WIDTH-1-col] );
-		std::swap( Ret._BadBitMask[col], Ret._BadBitMask[WIDTH-1-col] );
+		const int col = _Move.first.second - 1 + i;
+		if ( col < 0 || col >= TGeometry::WIDTH )
+			continue;
+		Ret._nHash ^= GetColumnHash<TGeometry>( col, Ret._GoodBitMask[col], Ret._BadBitMask[col] ) ^ GetColumnHash<TGeometry>( col, _GoodBitMask[i], _BadBitMask[i] );
+		AddCounts( Ret, col, -1 );
+		Ret._GoodBitMask[col] = _GoodBitMask[i];
+		Ret._BadBitMask[col] = _BadBitMask[i];
+		AddCounts( Ret, col, 1 );
 	}
+	DecideWinner( Ret );
 	return Ret;
 }
-CGameField VerticalFlip( const CGameField& Field )
+
+template<typename TGeometry>
+bool TToggleDelta<TGeometry>::IsPass( const TGameField<TGeometry>& PassField ) const
+{
+	for ( int i = 0; i < 3; ++i )
+	{
+		const int col = _Move.first.second - 1 + i;
+		if ( col >= 0 && col < TGeometry::WIDTH && (_GoodBitMask[i] != PassField._GoodBitMask[col] || _BadBitMask[i] != PassField._BadBitMask[col]) )
+			return false;
+	}
+	return true;
+}
+template<typename TGeometry>
+TGameField<TGeometry> ComposeToggleDeltas( const TGameField<TGeometry>& PassField, std::initializer_list<const TToggleDelta<TGeometry>*> Deltas )
+{
+	using COLMASK = typename TGeometry::COLMASK;
+	TGameField<TGeometry> Ret = PassField;
+	for ( const TToggleDelta<TGeometry>* pDelta : Deltas )
+	{
+		const COLMASK Window = COLMASK( ((7u << pDelta->_Move.first.first) >> 1) & ((1u << TGeometry::HEIGHT) - 1) ); // Rows row-1 to row+1
+		for ( int i = 0; i < 3; ++i )
+		{
+			const int col = pDelta->_Move.first.second - 1 + i;
+			if ( col < 0 || col >= TGeometry::WIDTH )
+				continue;
+			const COLMASK Good = COLMASK( (Ret._GoodBitMask[col] & ~Window) | (pDelta->_GoodBitMask[i] & Window) );
+			const COLMASK Bad = COLMASK( (Ret._BadBitMask[col] & ~Window) | (pDelta->_BadBitMask[i] & Window) );
+			if ( Good == Ret._GoodBitMask[col] && Bad == Ret._BadBitMask[col] )
+				continue;
+			Ret._nHash ^= GetColumnHash<TGeometry>( col, COLMASK( Good ^ Ret._GoodBitMask[col] ), COLMASK( Bad ^ Ret._BadBitMask[col] ) ); // The keys of a nibble are XORed per square
+			AddCounts( Ret, col, -1 );
+			Ret._GoodBitMask[col] = Good;
+			Ret._BadBitMask[col] = Bad;
+			AddCounts( Ret, col, 1 );
+		}
+	}
+	DecideWinner( Ret );
+	return Ret;
+}
+
+// Symmetries
+namespace
+{
+	template<int HEIGHT, typename COLMASK>
+	inline COLMASK ReverseRows( COLMASK x )
+	{
+		uint32_t v = x;
+		v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+		v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+		v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+		v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
+		v = (v >> 16) | (v << 16);
+		return COLMASK( v >> (32 - HEIGHT) );
+	}
+}
+template<typename TGeometry>
+TGameField<TGeometry> GetSymmetry( const TGameField<TGeometry>& Field, int nTransform )
 {
-	CGameField Ret = Field;
-	for ( int row = 0; row < HEIGHT/2; ++row ) for ( int col = 0; col < WIDTH; ++col )
+	constexpr int WIDTH = TGeometry::WIDTH;
+	constexpr int HEIGHT = TGeometry::HEIGHT;
+	TGameField<TGeometry> Ret = Field;
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		const int nFrom = (nTransform & 1) ? WIDTH-1-col : col;
+		Ret._GoodBitMask[col] = (nTransform & 2) ? ReverseRows<HEIGHT>( Field._GoodBitMask[nFrom] ) : Field._GoodBitMask[nFrom];
+		Ret._BadBitMask[col] = (nTransform & 2) ? ReverseRows<HEIGHT>( Field._BadBitMask[nFrom] ) : Field._BadBitMask[nFrom];
+	}
+	if ( nTransform != 0 )
 	{
-		ELifeMode temp = Ret.GetSquare( row, col );
-		Ret.SetSquare( row, col, Ret.GetSquare( HEIGHT-1-row, col ) );
-		Ret.SetSquare( HEIGHT-1-row, col, temp );
+		Ret.UpdateHash();
+		Ret.UpdateCounts();
 	}
 	return Ret;
 }
-std::vector<CGameField> GetSymmetries( const CGameField& Field )
+template<typename TGeometry>
+TGameField<TGeometry> HorizontalFlip( const TGameField<TGeometry>& Field )
+{
+	return GetSymmetry( Field, 1 );
+}
+template<typename TGeometry>
+TGameField<TGeometry> VerticalFlip( const TGameField<TGeometry>& Field )
 {
-	std::vector<CGameField> Ret = { Field };
-	for ( size_t i = 0, N = Ret.size(); i < N; ++i )
-		Ret.push_back( HorizontalFlip( Ret[i] ) );
-	for ( size_t i = 0, N = Ret.size(); i < N; ++i )
-		Ret.push_back( VerticalFlip( Ret[i] ) );
+	return GetSymmetry( Field, 2 );
+}
+template<typename TGeometry>
+std::vector<TGameField<TGeometry>> GetSymmetries( const TGameField<TGeometry>& Field )
+{
+	std::vector<TGameField<TGeometry>> Ret;
+	Ret.reserve( 4 );
+	ForEachSymmetry( Field, [&Ret]( const TGameField<TGeometry>& Mirror ) { Ret.push_back( Mirror ); } );
+	return Ret;
+}
+template<typename TGeometry>
+std::pair<TGameField<TGeometry>, int> Canonicalize( const TGameField<TGeometry>& Field )
+{
+	std::pair<TGameField<TGeometry>, int> Ret( Field, 0 );
+	for ( int nTransform = 1; nTransform < 4; ++nTransform )
+	{
+		TGameField<TGeometry> Mirror = GetSymmetry( Field, nTransform );
+		if ( SFieldCompare()( Mirror, Ret.first ) )
+			Ret = std::make_pair( Mirror, nTransform );
+	}
 	return Ret;
 }
 
-void PrintField(const CGameField& Field)
+template<typename TGeometry>
+void PrintField( const TGameField<TGeometry>& Field )
 {
 	std::cerr << "Game at time: " << Field._time << std::endl;
-	for (int i = 0; i < HEIGHT; ++i)
+	for (int i = 0; i < TGeometry::HEIGHT; ++i)
 	{
-		for (int j = 0; j < WIDTH; ++j)
+		for (int j = 0; j < TGeometry::WIDTH; ++j)
 		{
 			int x = Field.GetSquare( i, j );
 			std::cerr << (x == 1 ? '+' : (x == -1 ? 'o' : '.'));
@@ -356,12 +1196,21 @@ void WriteGames( const std::vector<CGame>& Games, std::ostream& output )
 CGame PlayGame( const CBot& Bot1, const CBot& Bot2, int nStartingBot ) // Returns all positions as they occured
 {
 	CGame Game( NewField( nStartingBot ) );
+	const bool bProjectCycles = Bot1.IsDeterministic() && Bot2.IsDeterministic();
+	const int nProjectBefore = MAX_ROUNDS - std::max( Bot1.GetHorizon(), Bot2.GetHorizon() ); // From there on the bots can see the draw by time, so they play
+	CCycleDetector Cycles;
+	Cycles.Push( Game.GetLastField(), false );
 	while ( Game.GetWinner() == -2 ) // none
 	{
 		const CBot& Bot = Game.GetLastField()._player_to_move == 1 ? Bot1 : Bot2;
 		TMoveIdentifier BestMove = Bot.ChooseMove( Game );
 
 		Game.MakeMove( BestMove );
+		Cycles.Push( Game.GetLastField(), BestMove.empty() );
+		// Both bots see the same field again after passing, so deterministic bots keep passing until MAX_ROUNDS comes within their horizon
+		const size_t nPeriod = bProjectCycles && Game.GetLastField()._time < nProjectBefore ? Cycles.GetPeriod() : 0;
+		if ( nPeriod != 0 && Game.GetLastField().IsSameField( Game._FieldsAndMoves[Game.size() - 1 - nPeriod].first ) )
+			Game.ProjectCycle( nPeriod, nProjectBefore );
 	}
 	return Game;
 }
@@ -415,14 +1264,18 @@ std::vector<CGame> ReadGames( const std::string& BotName, bool bNoError )
 	return ReadGames( input );
 }
 
-bool CGameField::operator==( const CGameField& O ) const
+template<typename TGeometry>
+bool TGameField<TGeometry>::operator==( const TGameField& O ) const
 {
 	return std::make_tuple( _GoodBitMask, _BadBitMask, _winner, _player_to_move, _time, _last_killed )
 		== std::make_tuple( O._GoodBitMask, O._BadBitMask, O._winner, O._player_to_move, O._time, O._last_killed );
 }
 
-void CGameField::SetSquare( unsigned char row, unsigned char col, ELifeMode value )
+template<typename TGeometry>
+void TGameField<TGeometry>::SetSquare( unsigned char row, unsigned char col, ELifeMode value )
 {
+	const COLMASK OldGood = _GoodBitMask[col];
+	const COLMASK OldBad = _BadBitMask[col];
 	if ( value == GOOD )
 		_GoodBitMask[col] |= (1 << row);
 	else if ( value == BAD )
@@ -432,9 +1285,50 @@ void CGameField::SetSquare( unsigned char row, unsigned char col, ELifeMode valu
 		_GoodBitMask[col] &= ~(1 << row);
 		_BadBitMask[col] &= ~(1 << row);
 	}
+	const auto& Tables = GetZobristTables<TGeometry>();
+	const int nBit = 1 << (row % 4);
+	if ( OldGood != _GoodBitMask[col] )
+	{
+		_nHash ^= Tables[0][col][row / 4][nBit];
+		_nGood += value == GOOD ? 1 : -1;
+	}
+	if ( OldBad != _BadBitMask[col] )
+	{
+		_nHash ^= Tables[1][col][row / 4][nBit];
+		_nBad += value == BAD ? 1 : -1;
+	}
+	if ( _GoodBitMask[col] | _BadBitMask[col] )
+		_nLiveCols |= 1u << col;
+	else
+		_nLiveCols &= ~(1u << col);
+}
+
+template<typename TGeometry>
+uint64_t TGameField<TGeometry>::GetHash() const
+{
+	return _player_to_move == -1 ? _nHash ^ PLAYER_KEY : _nHash;
+}
+template<typename TGeometry>
+void TGameField<TGeometry>::UpdateHash()
+{
+	_nHash = 0;
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		if ( _GoodBitMask[col] | _BadBitMask[col] ) // Empty columns hash to 0
+			_nHash ^= GetColumnHash<TGeometry>( col, _GoodBitMask[col], _BadBitMask[col] );
+	}
+}
+template<typename TGeometry>
+void TGameField<TGeometry>::UpdateCounts()
+{
+	_nGood = _nBad = 0;
+	_nLiveCols = 0;
+	for ( int col = 0; col < WIDTH; ++col )
+		AddCounts( *this, col, 1 );
 }
 
-ELifeMode CGameField::GetSquare( unsigned char row, unsigned char col ) const
+template<typename TGeometry>
+ELifeMode TGameField<TGeometry>::GetSquare( unsigned char row, unsigned char col ) const
 {
 	if ( _GoodBitMask[col] & (1 << row) )
 		return GOOD;
@@ -444,28 +1338,152 @@ ELifeMode CGameField::GetSquare( unsigned char row, unsigned char col ) const
 		return DEAD;
 }
 
-bool CGameField::IsSameField( const CGameField & Other ) const
+template<typename TGeometry>
+bool TGameField<TGeometry>::IsSameField( const TGameField & Other ) const
 {
 	if ( _GoodBitMask != Other._GoodBitMask || _BadBitMask != Other._BadBitMask )
 		return false;
 	return true;
 }
 
-CGameField CGameField::GetSuccessor( const CMove& Move ) const
+template<typename TGeometry>
+TGameField<TGeometry> TGameField<TGeometry>::GetSuccessor( const CMove& Move ) const
 {
 	return GetSuccessor( Move.GetIdentifierVector() );
 }
-CGameField CGameField::GetSuccessor( const TMoveIdentifier& Move ) const
+template<typename TGeometry>
+TGameField<TGeometry> TGameField<TGeometry>::GetSuccessor( const TMoveIdentifier& Move ) const
 {
-	CGameField Copy = *this;
+	TGameField Copy = *this;
 	for ( const TMovePart& MovePart : Move )
 	{
 		Copy.SetSquare( MovePart.first, MovePart.second ? ELifeMode( _player_to_move ) : DEAD );
 	}
 	return NextField( Copy );
 }
+template<typename TGeometry>
+TGameField<TGeometry> TGameField<TGeometry>::GetSuccessor( const TMoveIdentifier& Move, const TGameField& PassField ) const
+{
+	// A toggled square only affects its own and the two neighboring columns in the next generation
+	TGameField Copy = *this;
+	unsigned int nChangedCols = 0;
+	for ( const TMovePart& MovePart : Move )
+	{
+		Copy.SetSquare( MovePart.first, MovePart.second ? ELifeMode( _player_to_move ) : DEAD );
+		nChangedCols |= 7u << MovePart.first.second; // Bit col+1 means col
+	}
+	if ( nChangedCols == 0 )
+		return PassField;
+
+	std::array<COLMASK, WIDTH> Alive;
+	for ( int col = 0; col < WIDTH; ++col )
+		Alive[col] = Copy._GoodBitMask[col] | Copy._BadBitMask[col];
+
+	TGameField Ret = PassField;
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		if ( (nChangedCols >> (col+1)) & 1 )
+		{
+			Ret._nHash ^= GetColumnHash<TGeometry>( col, Ret._GoodBitMask[col], Ret._BadBitMask[col] );
+			AddCounts( Ret, col, -1 );
+			NextColumn( Copy, Alive, col, Ret._GoodBitMask[col], Ret._BadBitMask[col] );
+			Ret._nHash ^= GetColumnHash<TGeometry>( col, Ret._GoodBitMask[col], Ret._BadBitMask[col] );
+			AddCounts( Ret, col, 1 );
+		}
+	}
+	DecideWinner( Ret );
+	return Ret;
+}
+template<typename TGeometry>
+typename TGameField<TGeometry>::SUndo TGameField<TGeometry>::Make( const TMoveIdentifier& Move )
+{
+	SUndo Undo;
+	Undo._nHash = _nHash;
+	Undo._nGood = _nGood;
+	Undo._nBad = _nBad;
+	Undo._nLiveCols = _nLiveCols;
+	Undo._winner = _winner;
+	Undo._player_to_move = _player_to_move;
+	Undo._time = _time;
+	Undo._last_killed = _last_killed;
+	auto SaveColumn = [this, &Undo]( int col )
+	{
+		if ( (Undo._nSavedCols >> col) & 1 )
+			return;
+		Undo._nSavedCols |= 1u << col;
+		Undo._GoodBitMask[col] = _GoodBitMask[col];
+		Undo._BadBitMask[col] = _BadBitMask[col];
+	};
+
+	for ( const TMovePart& MovePart : Move )
+	{
+		SaveColumn( MovePart.first.second );
+		SetSquare( MovePart.first, MovePart.second ? ELifeMode( _player_to_move ) : DEAD );
+	}
+
+	std::array<COLMASK, WIDTH> Alive;
+	for ( int col = 0; col < WIDTH; ++col )
+		Alive[col] = _GoodBitMask[col] | _BadBitMask[col];
+	std::array<COLMASK, WIDTH> NextGood = {}, NextBad = {};
+	const uint32_t nActiveCols = GetActiveCols();
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		if ( (nActiveCols >> col) & 1 )
+			NextColumn( *this, Alive, col, NextGood[col], NextBad[col] );
+	}
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		if ( NextGood[col] == _GoodBitMask[col] && NextBad[col] == _BadBitMask[col] )
+			continue;
+		SaveColumn( col );
+		_nHash ^= GetColumnHash<TGeometry>( col, _GoodBitMask[col], _BadBitMask[col] ) ^ GetColumnHash<TGeometry>( col, NextGood[col], NextBad[col] );
+		AddCounts( *this, col, -1 );
+		_GoodBitMask[col] = NextGood[col];
+		_BadBitMask[col] = NextBad[col];
+		AddCounts( *this, col, 1 );
+	}
+
+	_last_killed = DEAD;
+	_time += 1;
+	_player_to_move = -_player_to_move;
+	DecideWinner( *this );
+	return Undo;
+}
+template<typename TGeometry>
+void TGameField<TGeometry>::Unmake( const SUndo& Undo )
+{
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		if ( (Undo._nSavedCols >> col) & 1 )
+		{
+			_GoodBitMask[col] = Undo._GoodBitMask[col];
+			_BadBitMask[col] = Undo._BadBitMask[col];
+		}
+	}
+	_nHash = Undo._nHash;
+	_nGood = Undo._nGood;
+	_nBad = Undo._nBad;
+	_nLiveCols = Undo._nLiveCols;
+	_winner = Undo._winner;
+	_player_to_move = Undo._player_to_move;
+	_time = Undo._time;
+	_last_killed = Undo._last_killed;
+}
+template<typename TGeometry>
+std::vector<TGameField<TGeometry>> TGameField<TGeometry>::GetSuccessors( const std::vector<TMoveIdentifier>& Moves ) const
+{
+	std::vector<TGameField> Ret( Moves.size(), *this );
+	for ( size_t i = 0; i < Moves.size(); ++i )
+	{
+		for ( const TMovePart& MovePart : Moves[i] )
+			Ret[i].SetSquare( MovePart.first, MovePart.second ? ELifeMode( _player_to_move ) : DEAD );
+	}
+	NextFieldBatch( Ret.data(), Ret.data(), Ret.size() );
+	return Ret;
+}
 
-bool CGameField::IsValidMove( const TMovePart& MovePart, bool bKillOnlySelf ) const
+template<typename TGeometry>
+bool TGameField<TGeometry>::IsValidMove( const TMovePart& MovePart, bool bKillOnlySelf ) const
 {
 	ELifeMode X = GetSquare( MovePart.first );
 	if ( MovePart.second )
@@ -485,7 +1503,8 @@ bool CGameField::IsValidMove( const TMovePart& MovePart, bool bKillOnlySelf ) co
 	}
 	return true;
 }
-bool CGameField::IsValidMove( const TMoveIdentifier& Move, bool bKillOnlySelf ) const
+template<typename TGeometry>
+bool TGameField<TGeometry>::IsValidMove( const TMoveIdentifier& Move, bool bKillOnlySelf ) const
 {
 	for ( const TMovePart& MovePart : Move )
 	{
@@ -495,22 +1514,23 @@ bool CGameField::IsValidMove( const TMoveIdentifier& Move, bool bKillOnlySelf )
 	return true;
 }
 
-void CGameField::ReadFromAPI( const std::string& str )
+template<typename TGeometry>
+void TGameField<TGeometry>::ReadFromAPI( const std::string& str )
 {
 	size_t i = 0;
 	for ( char ch : str )
 	{
-		if ( i >= AllFieldSquares.size() ) std::cerr << "Failed to read Field" << std::endl;
+		if ( i >= GetAllFieldSquares<TGeometry>().size() ) std::cerr << "Failed to read Field" << std::endl;
 		switch ( ch )
 		{
 		case '.':
-			SetSquare(AllFieldSquares[i++], DEAD);
+			SetSquare(GetAllFieldSquares<TGeometry>()[i++], DEAD);
 			break;
 		case '0':
-			SetSquare( AllFieldSquares[i++], BAD );
+			SetSquare( GetAllFieldSquares<TGeometry>()[i++], BAD );
 			break;
 		case '1':
-			SetSquare( AllFieldSquares[i++], GOOD );
+			SetSquare( GetAllFieldSquares<TGeometry>()[i++], GOOD );
 			break;
 		default:
 			if( ch != ',' ) std::cerr << "Unknown character when reading Field: " + ch << std::endl;
@@ -531,7 +1551,8 @@ inline std::ostream& operator<<( std::ostream& dest, ELifeMode source )
 	return dest << ( source == DEAD ? '.' : source == GOOD ? '+' : '-' );
 }
 
-void CGameField::ReadFromStream( std::istream& input )
+template<typename TGeometry>
+void TGameField<TGeometry>::ReadFromStream( std::istream& input )
 {
 	int winner;
 	input >> _time >> winner >> _player_to_move;
@@ -546,7 +1567,8 @@ void CGameField::ReadFromStream( std::istream& input )
 		}
 	}
 }
-void CGameField::WriteToStream( std::ostream& output ) const
+template<typename TGeometry>
+void TGameField<TGeometry>::WriteToStream( std::ostream& output ) const
 {
 	output << _time << " " << int(_winner) << " " << _player_to_move << std::endl;
 	for ( int row = 0; row < HEIGHT; ++row )
@@ -565,6 +1587,35 @@ void CGame::MakeMove( const TMoveIdentifier& Move )
 	_FieldsAndMoves.emplace_back( _FieldsAndMoves.back().first.GetSuccessor( Move ), TMoveIdentifier() );
 }
 
+void CGame::ProjectCycle( size_t nPeriod, int nEnd )
+{
+	while ( GetWinner() == CGameField::UNDETERMINED && GetLastField()._time < nEnd )
+	{
+		CGameField Next = _FieldsAndMoves[size() - nPeriod].first; // Reached by a pass, like Next
+		Next._time = GetLastField()._time + 1;
+		Next._winner = Next._time >= MAX_ROUNDS ? CGameField::DRAW : CGameField::UNDETERMINED; // Both players stay alive in the cycle
+		_FieldsAndMoves.back().second = TMoveIdentifier();
+		_FieldsAndMoves.emplace_back( Next, TMoveIdentifier() );
+	}
+}
+
+void CCycleDetector::Push( const CGameField& Field, bool bPass )
+{
+	_nPasses = bPass ? _nPasses + 1 : 0;
+	_Hashes[_nPushed++ % HISTORY] = Field.GetHash();
+}
+size_t CCycleDetector::GetPeriod() const
+{
+	const size_t nMaxPeriod = std::min( { _nPasses, _nPushed - 1, HISTORY - 1 } );
+	const uint64_t nLast = _Hashes[(_nPushed - 1) % HISTORY];
+	for ( size_t nPeriod = 2; nPeriod <= nMaxPeriod; nPeriod += 2 ) // The player to move is hashed, so periods are even
+	{
+		if ( _Hashes[(_nPushed - 1 - nPeriod) % HISTORY] == nLast )
+			return nPeriod;
+	}
+	return 0;
+}
+
 void CGame::PushFromAPI( const std::string& str )
 {
 	CGameField Field;
@@ -583,15 +1634,16 @@ void CGame::ReadFromStream( std::istream& input )
 	for ( int i = 0; i < N; ++i )
 	{
 		int M; input >> M;
-		TMoveIdentifier Move( M );
+		TMoveVector Parts( M );
 		for ( int j = 0; j < M; ++j )
 		{
 			std::string t; input >> t;
 			unsigned int row, col; input >> row >> col;
-			Move[j].first.first = (unsigned char)row;
-			Move[j].first.second = (unsigned char)col;
-			Move[j].second = t == "birth";
+			Parts[j].first.first = (unsigned char)row;
+			Parts[j].first.second = (unsigned char)col;
+			Parts[j].second = t == "birth";
 		}
+		const TMoveIdentifier Move( Parts );
 		_FieldsAndMoves.emplace_back( Next, Move );
 		Next = Next.GetSuccessor( Move );
 	}
@@ -615,3 +1667,30 @@ void CGame::WriteToStream( std::ostream& output ) const
 		}
 	}
 }
+
+#define INSTANTIATE_GAME_FIELD( TGeometry ) \
+	template class TGameField<TGeometry>; \
+	template TGameField<TGeometry> NewField<TGeometry>( int ); \
+	template TGameField<TGeometry> NextFieldSlow( const TGameField<TGeometry>& ); \
+	template TGameField<TGeometry> NextFieldFast( const TGameField<TGeometry>& ); \
+	template TGameField<TGeometry> NextFieldSuperFast( const TGameField<TGeometry>& ); \
+	template TGameField<TGeometry> NextFieldLookup( const TGameField<TGeometry>& ); \
+	template void SetNextFieldKernel( TNextFieldKernel<TGeometry> ); \
+	template TNextFieldKernel<TGeometry> GetNextFieldKernel<TGeometry>(); \
+	template TGameField<TGeometry> NextField( const TGameField<TGeometry>& ); \
+	template void NextFieldBatch( const TGameField<TGeometry>*, TGameField<TGeometry>*, size_t ); \
+	template std::vector<TGameField<TGeometry>> NextFieldBatch( const std::vector<TGameField<TGeometry>>& ); \
+	template size_t NextFieldN( const TGameField<TGeometry>&, size_t, TGameField<TGeometry>*, int*, int* ); \
+	template TGameField<TGeometry> HorizontalFlip( const TGameField<TGeometry>& ); \
+	template TGameField<TGeometry> VerticalFlip( const TGameField<TGeometry>& ); \
+	template TGameField<TGeometry> GetSymmetry( const TGameField<TGeometry>&, int ); \
+	template std::vector<TGameField<TGeometry>> GetSymmetries( const TGameField<TGeometry>& ); \
+	template std::pair<TGameField<TGeometry>, int> Canonicalize( const TGameField<TGeometry>& ); \
+	template void PrintField( const TGameField<TGeometry>& ); \
+	template struct TToggleDelta<TGeometry>; \
+	template std::vector<TToggleDelta<TGeometry>> GetSingleToggleDeltas( const TGameField<TGeometry>&, const TGameField<TGeometry>& ); \
+	template TGameField<TGeometry> ComposeToggleDeltas( const TGameField<TGeometry>&, std::initializer_list<const TToggleDelta<TGeometry>*> );
+
+INSTANTIATE_GAME_FIELD( SSmallGeometry )
+INSTANTIATE_GAME_FIELD( SFullGeometry )
+template TGameField<SSmallGeometry> NextFieldSWAR( const TGameField<SSmallGeometry>& );
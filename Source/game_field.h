@@ -8,16 +8,31 @@
 #include <array>
 #include <vector>
 #include <tuple>
+#include <algorithm>
+#include <cstdint>
 
-int ToInt( FieldSquare x );
-const auto AllFieldSquares = []() { // TODO (C++17): Make constexpr
-	std::array<FieldSquare, HEIGHT*WIDTH> Ret;
-	for (int i = 0; i < HEIGHT; ++i) for (int j = 0; j < WIDTH; ++j)
+template<typename TGeometry = SDefaultGeometry>
+int ToInt( FieldSquare x )
+{
+	return x.first*TGeometry::WIDTH+x.second;
+}
+template<typename TGeometry>
+std::array<FieldSquare, TGeometry::HEIGHT*TGeometry::WIDTH> CreateAllFieldSquares()
+{
+	std::array<FieldSquare, TGeometry::HEIGHT*TGeometry::WIDTH> Ret;
+	for (int i = 0; i < TGeometry::HEIGHT; ++i) for (int j = 0; j < TGeometry::WIDTH; ++j)
 	{
-		Ret[i*WIDTH + j] = FieldSquare(i, j);
+		Ret[i*TGeometry::WIDTH + j] = FieldSquare(i, j);
 	}
 	return Ret;
-}();
+}
+template<typename TGeometry>
+const std::array<FieldSquare, TGeometry::HEIGHT*TGeometry::WIDTH>& GetAllFieldSquares()
+{
+	static const auto Ret = CreateAllFieldSquares<TGeometry>();
+	return Ret;
+}
+const auto AllFieldSquares = CreateAllFieldSquares<SDefaultGeometry>(); // TODO (C++17): Make constexpr
 
 enum ELifeMode : signed char
 {
@@ -28,29 +43,50 @@ enum ELifeMode : signed char
 ELifeMode operator-( ELifeMode x );
 
 class CMove;
-class CGameField
+template<typename TGeometry>
+class TGameField
 {
 public:
+	static constexpr int WIDTH = TGeometry::WIDTH;
+	static constexpr int HEIGHT = TGeometry::HEIGHT;
+	static_assert( HEIGHT <= 16 && WIDTH <= 31, "TMoveIdentifier packs a square in 9 bits" );
+	using COLMASK = typename TGeometry::COLMASK;
+
 	void SetSquare( unsigned char row, unsigned char col, ELifeMode value );
 	ELifeMode GetSquare( unsigned char row, unsigned char col ) const;
 	void SetSquare( FieldSquare s, ELifeMode value ) { SetSquare( s.first, s.second, value ); }
 	ELifeMode GetSquare( FieldSquare s ) const { return GetSquare( s.first, s.second ); };
 
-	bool IsSameField( const CGameField& Other ) const;
-	CGameField GetSuccessor( const CMove& Move ) const;
-	CGameField GetSuccessor( const TMoveIdentifier& Move ) const;
+	bool IsSameField( const TGameField& Other ) const;
+	TGameField GetSuccessor( const CMove& Move ) const;
+	TGameField GetSuccessor( const TMoveIdentifier& Move ) const;
+	TGameField GetSuccessor( const TMoveIdentifier& Move, const TGameField& PassField ) const; // Only re-steps the columns around Move. PassField = NextField( *this )
+	std::vector<TGameField> GetSuccessors( const std::vector<TMoveIdentifier>& Moves ) const; // Stepped together by NextFieldBatch
+
+	struct SUndo; // What Make changed, for Unmake
+	SUndo Make( const TMoveIdentifier& Move ); // In place: *this becomes GetSuccessor( Move )
+	void Unmake( const SUndo& Undo );
 	bool IsValidMove( const TMoveIdentifier& Move, bool bKillOnlySelf ) const;
 	bool IsValidMove( const TMovePart& Move, bool bKillOnlySelf ) const;
 	void ReadFromAPI( const std::string& str );
 	void ReadFromStream( std::istream& input );
 	void WriteToStream( std::ostream & output ) const;
 
-	bool operator==( const CGameField& O ) const;
-	bool operator!=( const CGameField& O ) const { return !(*this == O); }
+	bool operator==( const TGameField& O ) const;
+	bool operator!=( const TGameField& O ) const { return !(*this == O); }
+
+	uint64_t GetHash() const; // 64-bit Zobrist key of the squares and the player to move
+	void UpdateHash(); // Needed after writing the bit masks directly
+	void UpdateCounts(); // Same, for _nGood, _nBad and _nLiveCols
+	uint32_t GetActiveCols() const { return (_nLiveCols | (_nLiveCols << 1) | (_nLiveCols >> 1)) & ((1u << WIDTH) - 1); } // Columns that can be alive in the next generation
 
 // Also public
 	std::array<COLMASK, WIDTH> _GoodBitMask = {};
 	std::array<COLMASK, WIDTH> _BadBitMask = {};
+	uint64_t _nHash = 0; // Zobrist key of the squares only, kept up to date by SetSquare
+	short _nGood = 0; // Live squares per player, kept up to date like _nHash
+	short _nBad = 0;
+	uint32_t _nLiveCols = 0; // Bit col is set if column col has a live square
 
 	enum EResult : signed char {
 		UNDETERMINED = -2,
@@ -63,17 +99,94 @@ public:
 	short _time = 0;
 	ELifeMode _last_killed = DEAD;
 };
+template<typename TGeometry> constexpr int TGameField<TGeometry>::WIDTH;
+template<typename TGeometry> constexpr int TGameField<TGeometry>::HEIGHT;
+template<typename TGeometry>
+struct TGameField<TGeometry>::SUndo
+{
+	unsigned int _nSavedCols = 0; // Bit col is set if column col was saved, only those entries are valid
+	uint64_t _nHash;
+	short _nGood;
+	short _nBad;
+	uint32_t _nLiveCols;
+	std::array<COLMASK, WIDTH> _GoodBitMask;
+	std::array<COLMASK, WIDTH> _BadBitMask;
+	EResult _winner;
+	signed char _player_to_move;
+	short _time;
+	ELifeMode _last_killed;
+};
+
+// Member and free function templates are defined in game_field.cpp, for SSmallGeometry and SFullGeometry
+template<typename TGeometry = SDefaultGeometry>
+TGameField<TGeometry> NewField( int player_to_move = 1 );
+
+template<typename TGeometry> TGameField<TGeometry> NextFieldSlow( const TGameField<TGeometry>& Field );
+template<typename TGeometry> TGameField<TGeometry> NextFieldFast( const TGameField<TGeometry>& Field );
+template<typename TGeometry> TGameField<TGeometry> NextFieldSuperFast( const TGameField<TGeometry>& Field );
+template<typename TGeometry> TGameField<TGeometry> NextFieldLookup( const TGameField<TGeometry>& Field ); // Table driven, 2 squares per lookup
+template<typename TGeometry> TGameField<TGeometry> NextFieldSWAR( const TGameField<TGeometry>& Field ); // 8 columns per uint64_t, only for 8-bit columns
+template<typename TGeometry>
+using TNextFieldKernel = TGameField<TGeometry> (*)( const TGameField<TGeometry>& );
+template<typename TGeometry> void SetNextFieldKernel( TNextFieldKernel<TGeometry> pKernel ); // Not thread safe, set it before starting any games
+template<typename TGeometry> TNextFieldKernel<TGeometry> GetNextFieldKernel();
+template<typename TGeometry> TGameField<TGeometry> NextField( const TGameField<TGeometry>& Field ); // Calls the selected kernel. Default: NextFieldSWAR on 8-bit columns, else NextFieldSuperFast (NextFieldLookup with LOOKUP_KERNEL)
+template<typename TGeometry> void NextFieldBatch( const TGameField<TGeometry>* pFields, TGameField<TGeometry>* pOut, size_t N ); // Many boards at once, vectorized for the CPU (cpu_dispatch.h). pOut may equal pFields
+template<typename TGeometry> std::vector<TGameField<TGeometry>> NextFieldBatch( const std::vector<TGameField<TGeometry>>& Fields );
+
+// Pass successors of Field. Stops stepping once _winner is decided, so later generations repeat the last one. Still lifes and period 2 boards are copied, not stepped
+template<typename TGeometry>
+size_t NextFieldN( const TGameField<TGeometry>& Field, size_t K, TGameField<TGeometry>* pFields, int* pGood, int* pBad ); // Returns the number of generations stepped (at least 1)
+template<size_t K, typename TGeometry = SDefaultGeometry>
+struct SLookahead
+{
+	const TGameField<TGeometry>& Get( size_t k ) const { return _Fields[std::min( k, _nGenerations-1 )]; }
+
+	std::array<TGameField<TGeometry>, K> _Fields; // _Fields[0] is the field itself
+	std::array<int, K> _nGood = {}; // Live squares of player 1
+	std::array<int, K> _nBad = {}; // Live squares of player -1
+	size_t _nGenerations = 0;
+};
+template<size_t K, typename TGeometry>
+SLookahead<K, TGeometry> NextFieldN( const TGameField<TGeometry>& Field )
+{
+	SLookahead<K, TGeometry> Ret;
+	Ret._nGenerations = NextFieldN( Field, K, Ret._Fields.data(), Ret._nGood.data(), Ret._nBad.data() );
+	return Ret;
+}
 
-CGameField NewField( int player_to_move = 1 );
+// Successors of all single toggles from one set of neighbor-count bitplanes. A toggle at (row, col) only changes the 3x3 around it, in columns col-1 to col+1 of PassField
+template<typename TGeometry>
+struct TToggleDelta
+{
+	using COLMASK = typename TGeometry::COLMASK;
+	TGameField<TGeometry> GetSuccessor( const TGameField<TGeometry>& PassField ) const; // Same as Field.GetSuccessor( { _Move }, PassField )
+	bool IsPass( const TGameField<TGeometry>& PassField ) const; // GetSuccessor( PassField ) == PassField
 
-CGameField NextFieldSlow( const CGameField& Field );
-CGameField NextFieldFast( const CGameField& Field );
-CGameField NextFieldSuperFast( const CGameField& Field );
-CGameField NextField( const CGameField& Field ); // Alias for NextFieldSuperFast
+	TMovePart _Move;
+	std::array<COLMASK, 3> _GoodBitMask; // Columns col-1, col and col+1 of the successor, 0 outside the field
+	std::array<COLMASK, 3> _BadBitMask;
+};
+template<typename TGeometry>
+std::vector<TToggleDelta<TGeometry>> GetSingleToggleDeltas( const TGameField<TGeometry>& Field, const TGameField<TGeometry>& PassField ); // Every valid birth, then every kill, in AllFieldSquares order
+// Successor of several toggles at once. Only for toggles that are pairwise AreIndependent, so their 3x3 windows are apart and each is read off its own delta
+template<typename TGeometry>
+TGameField<TGeometry> ComposeToggleDeltas( const TGameField<TGeometry>& PassField, std::initializer_list<const TToggleDelta<TGeometry>*> Deltas );
+using CToggleDelta = TToggleDelta<SDefaultGeometry>;
 
-std::vector<CGameField> GetSymmetries( const CGameField& Field );
+template<typename TGeometry> TGameField<TGeometry> HorizontalFlip( const TGameField<TGeometry>& Field );
+template<typename TGeometry> TGameField<TGeometry> VerticalFlip( const TGameField<TGeometry>& Field );
+template<typename TGeometry> TGameField<TGeometry> GetSymmetry( const TGameField<TGeometry>& Field, int nTransform ); // Bit 0: HorizontalFlip, bit 1: VerticalFlip. Every transform is its own inverse
+template<typename TGeometry, typename Functor>
+void ForEachSymmetry( const TGameField<TGeometry>& Field, const Functor& f ) // Same order as GetSymmetries, without allocating
+{
+	for ( int nTransform = 0; nTransform < 4; ++nTransform )
+		f( GetSymmetry( Field, nTransform ) );
+}
+template<typename TGeometry> std::vector<TGameField<TGeometry>> GetSymmetries( const TGameField<TGeometry>& Field );
+template<typename TGeometry> std::pair<TGameField<TGeometry>, int> Canonicalize( const TGameField<TGeometry>& Field ); // Least symmetric image by SFieldCompare, and its transform
 
-void PrintField(const CGameField& Field);
+template<typename TGeometry> void PrintField( const TGameField<TGeometry>& Field );
 void DrawNumberFancy( double v, bool bAllowNegative = true ); // [-1,1] or [0,1]
 
 class CMove;
@@ -91,13 +204,27 @@ public:
 	std::vector< std::pair< CGameField, TMoveIdentifier > > _FieldsAndMoves;
 
 	void PushFromAPI( const std::string& str );
+	void ProjectCycle( size_t nPeriod, int nEnd = MAX_ROUNDS ); // The last nPeriod moves were passes back to an equal field: appends passes up to _time nEnd or the end of the game without stepping
 
 	void ReadFromStream( std::istream& input );
 	void WriteToStream( std::ostream & output ) const;
 };
 
+// Hashes of the last few fields, to spot a game that keeps passing around a still life or an oscillator
+class CCycleDetector
+{
+public:
+	void Push( const CGameField& Field, bool bPass ); // Start with the first field, then every field after a move
+	size_t GetPeriod() const; // Plies back to a field with the same hash, all of them passes. 0 if none
+private:
+	static constexpr size_t HISTORY = 8; // Periods up to 6 plies, a board period of 3 with both players passing
+	std::array<uint64_t, HISTORY> _Hashes = {}; // Push n is at n % HISTORY
+	size_t _nPushed = 0;
+	size_t _nPasses = 0; // In a row, up to the last push
+};
+
 class CBot;
-CGame PlayGame( const CBot& Bot1, const CBot& Bot2, int nStartingBot = 1 );
+CGame PlayGame( const CBot& Bot1, const CBot& Bot2, int nStartingBot = 1 ); // Passing cycles between IsDeterministic bots are projected up to GetHorizon plies before MAX_ROUNDS, the rest is played
 
 void PlayAndWriteGames( const CBot& Bot, const std::string& BotName, int N );
 
@@ -108,15 +235,16 @@ std::vector<CGame> ReadGames( const std::string& BotName, bool bNoError = false
 
 struct SFieldCompare
 {
-	bool operator()( const CGameField& lhs, const CGameField& rhs ) const
+	template<typename TGeometry>
+	bool operator()( const TGameField<TGeometry>& lhs, const TGameField<TGeometry>& rhs ) const
 	{
-		for ( size_t col = 0; col < WIDTH; ++col )
+		for ( size_t col = 0; col < TGeometry::WIDTH; ++col )
 		{
 			if ( lhs._GoodBitMask[col] == rhs._GoodBitMask[col] )
 				continue;
 			return lhs._GoodBitMask[col] < rhs._GoodBitMask[col];
 		}
-		for ( size_t col = 0; col < WIDTH; ++col )
+		for ( size_t col = 0; col < TGeometry::WIDTH; ++col )
 		{
 			if ( lhs._BadBitMask[col] == rhs._BadBitMask[col] )
 				continue;
@@ -127,15 +255,17 @@ struct SFieldCompare
 };
 struct SFieldEqual
 {
-	bool operator()( const CGameField& lhs, const CGameField& rhs ) const
+	template<typename TGeometry>
+	bool operator()( const TGameField<TGeometry>& lhs, const TGameField<TGeometry>& rhs ) const
 	{
 		return lhs._GoodBitMask == rhs._GoodBitMask && lhs._BadBitMask == rhs._BadBitMask;
 	}
 };
 struct SFieldHasher
 {
-	auto operator()( const CGameField& Field ) const
+	template<typename TGeometry>
+	size_t operator()( const TGameField<TGeometry>& Field ) const
 	{
-		return SuperFastHash( Field._GoodBitMask, Field._BadBitMask );
+		return size_t( Field._nHash ); // Like SFieldEqual, ignores the player to move
 	}
 };
@@ -5,24 +5,44 @@
 #include "NeuralNet/propagation_data.h"
 #include "bot.h"
 
-template<size_t DEPTH = 1, size_t ABS = 0, typename TBot = CPassBot>
+template<size_t DEPTH = 1, size_t ABS = 0, typename TBot = CPassBot, typename TGeometry = SDefaultGeometry>
 struct SSimulatedInput
 {
+	using TField = TGameField<TGeometry>;
+	constexpr static int WIDTH = TGeometry::WIDTH;
+	constexpr static int HEIGHT = TGeometry::HEIGHT;
 	constexpr static size_t OUT_DEPTH = DEPTH * (ABS+1);
-	static CGameField GetSuccessorField( const CGameField& Field )
+	static TField GetSuccessorField( const TField& Field ) // Bots play CGame, so only on the default geometry
 	{
 		static const TBot Bot;
 		return Field.GetSuccessor( Bot.ChooseMove( CGame( Field ) ) );
 	}
-	static auto Get( CGameField Field, int nPlayer )
+	static SLookahead<DEPTH, TGeometry> GetLookahead( const TField& Field, std::true_type ) // Passing bot
+	{
+		return NextFieldN<DEPTH>( Field );
+	}
+	static SLookahead<DEPTH, TGeometry> GetLookahead( const TField& Field, std::false_type ) // Live counts are not filled
+	{
+		SLookahead<DEPTH, TGeometry> Ret;
+		Ret._Fields[0] = Field;
+		for ( Ret._nGenerations = 1; Ret._nGenerations < DEPTH; ++Ret._nGenerations )
+		{
+			const TField& Prev = Ret._Fields[Ret._nGenerations-1];
+			if ( Prev._winner != TField::UNDETERMINED )
+				break;
+			Ret._Fields[Ret._nGenerations] = GetSuccessorField( Prev );
+		}
+		return Ret;
+	}
+	static auto Get( const TField& StartField, int nPlayer )
 	{
 		CPropagationData<OUT_DEPTH, HEIGHT*WIDTH+1, 1> Ret;
-		const int nPlayerToMove = Field._player_to_move;
+		const int nPlayerToMove = StartField._player_to_move;
 		const double vGood = double( nPlayer ) / OUT_DEPTH;
+		const auto Lookahead = GetLookahead( StartField, std::is_same<TBot, CPassBot>() );
 		for ( size_t d = 0; d < DEPTH; ++d )
 		{
-			if ( d != 0 && Field._winner == CGameField::UNDETERMINED )
-				Field = GetSuccessorField( Field );
+			const TField& Field = Lookahead.Get( d );
 			for ( size_t nAbs = 0; nAbs <= ABS; ++nAbs )
 			{
 				const size_t nDepth = d*(ABS+1)+nAbs;
@@ -35,17 +55,19 @@ struct SSimulatedInput
 							: vGood * Field.GetSquare( row, col );
 					}
 				}
-				Ret.AccessData( nDepth, WIDTH*HEIGHT ) = Field._winner == CGameField::UNDETERMINED ? 0.0 : vGood * Field._winner * 10;
+				Ret.AccessData( nDepth, WIDTH*HEIGHT ) = Field._winner == TField::UNDETERMINED ? 0.0 : vGood * Field._winner * 10;
 			}
 		}
 		Ret.AccessExtra( 0 ) = vGood * nPlayerToMove;
 		return Ret;
 	}
-	constexpr static size_t SIZE = decltype(Get( NewField(), 1 ))::_TotalSize;
+	constexpr static size_t SIZE = decltype(Get( NewField<TGeometry>(), 1 ))::_TotalSize;
+	constexpr static int LOOKAHEAD = std::is_same<TBot, CPassBot>::value ? int( DEPTH ) - 1 : MAX_ROUNDS; // Generations past the field. Another TBot can look further each generation
 };
 
 struct SUniformInputScore
 {
+	template<int HEIGHT = Settings::HEIGHT>
 	static auto Get()
 	{
 		std::vector<double> Ret( 1 << HEIGHT, 0.0 );
@@ -58,9 +80,11 @@ struct SUniformInputScore
 		return Ret;
 	}
 	constexpr static bool BOOST_ENEMY = false;
+	constexpr static bool IS_POPCOUNT = true; // Score of a column is its number of live squares, so the field counts can be used
 };
 struct SSpecialInputScore
 {
+	template<int HEIGHT = Settings::HEIGHT>
 	static auto Get()
 	{
 		std::vector<double> Ret( 1 << HEIGHT, 0.0 );
@@ -73,30 +97,34 @@ struct SSpecialInputScore
 		return Ret;
 	}
 	constexpr static bool BOOST_ENEMY = true;
+	constexpr static bool IS_POPCOUNT = true;
 };
 
-template<size_t DEPTH, typename TInputScore = SUniformInputScore>
+template<size_t DEPTH, typename TInputScore = SUniformInputScore, typename TGeometry = SDefaultGeometry>
 struct SDominationInput
 {
-	static auto Get( CGameField Field, int nPlayer )
+	static auto Get( const TGameField<TGeometry>& StartField, int nPlayer )
 	{
 		std::array<double, DEPTH> Ret = {};
+		const auto Lookahead = NextFieldN<DEPTH>( StartField );
 		for( int nDepth = 0; nDepth < DEPTH; ++nDepth )
 		{
-			if ( nDepth != 0 && Field._winner == CGameField::UNDETERMINED )
-				Field = NextField( Field );
-			
-			const auto& GoodBitMasks = nPlayer == 1 ? Field._GoodBitMask : Field._BadBitMask;
-			const auto& BadBitMasks = nPlayer == -1 ? Field._GoodBitMask : Field._BadBitMask;
-			
-			static const auto Score = TInputScore::Get();
-
-			double vGood = 0;
-			double vBad = 0;
-			for ( int col = 0; col < WIDTH; ++col )
+			double vGood = nPlayer == 1 ? Lookahead._nGood[nDepth] : Lookahead._nBad[nDepth];
+			double vBad = nPlayer == -1 ? Lookahead._nGood[nDepth] : Lookahead._nBad[nDepth];
+			if ( !TInputScore::IS_POPCOUNT )
 			{
-				vGood += Score[GoodBitMasks[col]];
-				vBad += Score[BadBitMasks[col]];
+				const TGameField<TGeometry>& Field = Lookahead.Get( nDepth );
+				const auto& GoodBitMasks = nPlayer == 1 ? Field._GoodBitMask : Field._BadBitMask;
+				const auto& BadBitMasks = nPlayer == -1 ? Field._GoodBitMask : Field._BadBitMask;
+
+				static const auto Score = TInputScore::template Get<TGeometry::HEIGHT>();
+
+				vGood = vBad = 0;
+				for ( int col = 0; col < TGeometry::WIDTH; ++col )
+				{
+					vGood += Score[GoodBitMasks[col]];
+					vBad += Score[BadBitMasks[col]];
+				}
 			}
 			if ( TInputScore::BOOST_ENEMY )
 				vBad *= 2;
@@ -109,34 +137,29 @@ struct SDominationInput
 		return Ret;
 	}
 	constexpr static size_t SIZE = DEPTH;
+	constexpr static int LOOKAHEAD = int( DEPTH ) - 1;
 };
 
-template<size_t DEPTH = 1>
+template<size_t DEPTH = 1, typename TGeometry = SDefaultGeometry>
 struct SMixedInput
 {
+	constexpr static int WIDTH = TGeometry::WIDTH;
+	constexpr static int HEIGHT = TGeometry::HEIGHT;
 	constexpr static size_t OUT_DEPTH = DEPTH;
-	static auto Get( CGameField Field, int nPlayer )
+	static auto Get( const TGameField<TGeometry>& StartField, int nPlayer )
 	{
 		CPropagationData<OUT_DEPTH, HEIGHT*WIDTH, DEPTH> Ret;
-		const int nPlayerToMove = Field._player_to_move;
 		const double vGood = double( nPlayer ) / ( OUT_DEPTH * HEIGHT*WIDTH );
+		const auto Lookahead = NextFieldN<DEPTH>( StartField );
 		for ( size_t d = 0; d < DEPTH; ++d )
 		{
-			if ( d != 0 && Field._winner == CGameField::UNDETERMINED )
-				Field = NextField( Field );
-			int nGood = 0;
-			int nBad = 0;
+			const TGameField<TGeometry>& Field = Lookahead.Get( d );
+			const int nGood = nPlayer == 1 ? Lookahead._nGood[d] : Lookahead._nBad[d];
+			const int nBad = nPlayer == 1 ? Lookahead._nBad[d] : Lookahead._nGood[d];
 			for ( int row = 0; row < HEIGHT; ++row )
 			{
 				for ( int col = 0; col < WIDTH; ++col )
-				{
-					ELifeMode X = Field.GetSquare( row, col );
-					if ( X == nPlayer )
-						++nGood;
-					else if ( X == -nPlayer )
-						++nBad;
-					Ret.AccessData( d, row*WIDTH+col ) = vGood * X;
-				}
+					Ret.AccessData( d, row*WIDTH+col ) = vGood * Field.GetSquare( row, col );
 			}
 			if ( nGood == 0 && nBad == 0 )
 				Ret.AccessExtra( d ) = 0.0;
@@ -145,13 +168,17 @@ struct SMixedInput
 		}
 		return Ret;
 	}
-	constexpr static size_t SIZE = decltype(Get( NewField(), 1 ))::_TotalSize;
+	constexpr static size_t SIZE = decltype(Get( NewField<TGeometry>(), 1 ))::_TotalSize;
+	constexpr static int LOOKAHEAD = int( DEPTH ) - 1;
 };
 
-struct SMoveDeltaInput
+template<typename TGeometry = SDefaultGeometry>
+struct TMoveDeltaInput
 {
+	constexpr static int WIDTH = TGeometry::WIDTH;
+	constexpr static int HEIGHT = TGeometry::HEIGHT;
 	enum EDepths { BIRTH_NEAR, KILL_ME_NEAR, KILL_ENEMY_NEAR, BIRTH_HERE, KILL_ME_HERE, KILL_ENEMY_HERE, NUM_OF };
-	static CPropagationData< NUM_OF, WIDTH*HEIGHT, 1 > Get( const CGameField& Field, int nPlayer )
+	static CPropagationData< NUM_OF, WIDTH*HEIGHT, 1 > Get( const TGameField<TGeometry>& Field, int nPlayer )
 	{
 		CPropagationData< NUM_OF, WIDTH*HEIGHT, 1 > Ret;
 		// Depth 0: how am I affected by 1 extra neighbor (of nPlayer type).
@@ -162,10 +189,18 @@ struct SMoveDeltaInput
 		// Depth 5: how am I affected by KILL_ENEMY here
 		// Extra 0: Domination after pass
 
+		const double vImpossible = -100000.0;
+		const uint32_t nActiveCols = Field.GetActiveCols(); // Squares in other columns are dead with no neighbors
 		for ( int row = 0; row < HEIGHT; ++row )
 		{
 			for ( int col = 0; col < WIDTH; ++col )
 			{
+				if ( !((nActiveCols >> col) & 1) )
+				{
+					Ret.AccessData( KILL_ME_HERE, row*WIDTH+col ) = vImpossible;
+					Ret.AccessData( KILL_ENEMY_HERE, row*WIDTH+col ) = vImpossible;
+					continue;
+				}
 				int nNeighbors = 0;
 				int nDominant = 0;
 				for ( int nOtherRow = row - 1; nOtherRow <= row + 1; ++nOtherRow )
@@ -188,7 +223,6 @@ struct SMoveDeltaInput
 				}
 				int X = ELifeMode( int( Field.GetSquare( row, col ) ) * nPlayer );
 				const int nPos = row*WIDTH+col;
-				const double vImpossible = -100000.0;
 				if ( X != DEAD )
 				{
 					Ret.AccessData( BIRTH_HERE, nPos ) = vImpossible;
@@ -249,8 +283,10 @@ struct SMoveDeltaInput
 				}
 			}
 		}
-		Ret.AccessExtra( 0 ) = SDominationInput<1>::Get( NextField( Field ), nPlayer )[0];
+		Ret.AccessExtra( 0 ) = SDominationInput<1, SUniformInputScore, TGeometry>::Get( NextField( Field ), nPlayer )[0];
 		return Ret;
 	}
-	constexpr static size_t SIZE = decltype(Get( NewField(), 1 ))::_TotalSize;
-};
\ No newline at end of file
+	constexpr static size_t SIZE = decltype(Get( NewField<TGeometry>(), 1 ))::_TotalSize;
+	constexpr static int LOOKAHEAD = 0;
+};
+using SMoveDeltaInput = TMoveDeltaInput<>;
\ No newline at end of file
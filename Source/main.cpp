@@ -6,6 +6,7 @@
 #include "divide_and_conquer.h"
 #include "input_data.h"
 #include "fast_divide_and_conquer.h"
+#include "benchmark.h"
 
 #include <array>
 #include <utility>
@@ -143,27 +144,6 @@ void TrySeriousCandidates( const TBot& Bot, std::vector<int> Values )
 	std::cout << std::endl;
 }
 
-void TestConwayRule()
-{
-	for ( int i = 0; i < 10000; ++i )
-	{
-		auto Field = NewField();
-		auto SlowNext = NextFieldSlow( Field );
-		auto FastNext = NextFieldFast( Field );
-		auto SuperFastNext = NextFieldSuperFast( Field );
-		if ( SlowNext != FastNext || FastNext != SuperFastNext )
-		{
-			std::cout << "NOOOOOOOOOO!!!!" << std::endl;
-			PrintField( Field );
-			PrintField( SlowNext );
-			PrintField( FastNext );
-			PrintField( SuperFastNext );
-			NextFieldSlow( Field );
-		}
-	}
-	std::cout << "Conway OK!" << std::endl;
-}
-
 TMoveIdentifier BotChooseMove( const CBot& Bot, const CGame& Game )
 {
 	return Bot.ChooseMove( Game );
@@ -312,6 +292,9 @@ auto TryPredictMoves( const std::vector<CGame>& Games, const TDividerBot& Divide
 
 int main()
 {
+#ifdef AUTOTUNE_KERNELS
+	AutotuneKernels();
+#endif
 #ifndef TESTING
 	try
 	{
@@ -341,6 +324,11 @@ int main()
 	std::cout << std::fixed;
 	std::cout.precision( 3 );
 
+#ifdef BENCHMARK
+	RunBenchmarks();
+	return RunConwayFuzzer( 1000000 ) ? 0 : 1;
+#endif
+
 	constexpr size_t DEPTH = 3;
 	const int nSampleBirths = 500;
 
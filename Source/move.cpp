@@ -2,7 +2,8 @@
 #include "game_field.h"
 #include "util.h"
 
-#include <set>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 
 std::string GetCoordinateName( const FieldSquare& x )
@@ -28,62 +29,69 @@ std::string GetMoveName( const TMoveIdentifier& Move )
 	return "Unknown Move!";
 }
 
-std::vector<const CMove*> GetValidMoves(const CGameField& Field, int nSampleBirths )
+template<typename TGeometry>
+std::vector<TMoveIdentifier> GetValidMoves(const TGameField<TGeometry>& Field, int nSampleBirths )
 {
-	std::vector<const CMove*> Ret;
-	Ret.push_back( &GetPass() );
-	for ( const FieldSquare& X : AllFieldSquares )
+	const TMoveGenerator<TGeometry> Generator( Field );
+	std::vector<TMoveIdentifier> Ret;
+	auto Add = [&Ret]( const TMoveIdentifier& Move ) { Ret.push_back( Move ); };
+	if ( nSampleBirths == -1 )
 	{
-		if ( Field.GetSquare( X ) != DEAD )
-			Ret.push_back( &GetKill( ToInt( X ) ) );
+		Ret.reserve( Generator.size() );
+		Generator.ForEach( Add );
 	}
-	std::vector<int> SacrificeInts;
-	std::vector<int> BirthInts;
-	for ( int i = 0; i < AllFieldSquares.size(); ++i )
-	{
-		const ELifeMode life = Field.GetSquare( AllFieldSquares[i] );
-		if ( life == DEAD )
-			BirthInts.push_back( i );
-		else if ( life == Field._player_to_move )
-			SacrificeInts.push_back( i );
-	}
-	const int nValidBirths = int(SacrificeInts.size() * (SacrificeInts.size() - 1) * BirthInts.size()) / 2;
-	if ( nSampleBirths == -1 || nSampleBirths >= nValidBirths )
+	else
 	{
-		for ( int nSacrifice1 : SacrificeInts )
-		{
-			for ( int nSacrifice2 : SacrificeInts ) if ( nSacrifice2 > nSacrifice1 )
-			{
-				for ( int nBirth : BirthInts )
-					Ret.push_back( &GetBirth( nBirth, nSacrifice1, nSacrifice2 ) );
-			}
-		}
+		Ret.reserve( 1 + Generator.GetKillCount() + std::min( size_t( nSampleBirths ), Generator.GetBirthCount() ) );
+		Generator.ForEachSampled( nSampleBirths, Add );
 	}
-	else
+	return Ret;
+}
+
+template<typename TGeometry>
+TMoveGenerator<TGeometry>::TMoveGenerator( const TGameField<TGeometry>& Field )
+{
+	constexpr int WIDTH = TGeometry::WIDTH;
+	// GetSquare reads GOOD first, and a _player_to_move other than 1 or -1 owns nothing
+	const uint32_t nOwnGood = Field._player_to_move == 1 ? ~0u : 0u;
+	const uint32_t nOwnBad = Field._player_to_move == -1 ? ~0u : 0u;
+	for ( int row = 0; row < TGeometry::HEIGHT; ++row )
 	{
-		std::set<int> SelectedBirths;
-		KnuthShuffle( SacrificeInts );
-		KnuthShuffle( BirthInts );
-		for ( int i = nValidBirths - nSampleBirths; i < nValidBirths; ++i )
+		uint32_t Good = 0, Bad = 0; // Bit col of this row
+		for ( int col = 0; col < WIDTH; ++col )
 		{
-			const int nRand = SafeRand() % (i + 1);
-			const int nSelected = SelectedBirths.count( nRand ) ? i : nRand;
-			SelectedBirths.insert( nSelected );
+			Good |= ((uint32_t( Field._GoodBitMask[col] ) >> row) & 1u) << col;
+			Bad |= ((uint32_t( Field._BadBitMask[col] ) >> row) & 1u) << col;
 		}
-		for ( size_t i : SelectedBirths )
+		auto Append = [row]( uint32_t x, TSquares& Squares, size_t& nSquares )
 		{
-			const size_t nBirth = i % BirthInts.size();
-			i /= BirthInts.size();
-
-			size_t nSacrifice1 = 0;
-			while ( i >= SacrificeInts.size() - nSacrifice1 - 1 )
-				i -= SacrificeInts.size() - nSacrifice1++ - 1;
-			const size_t nSacrifice2 = nSacrifice1 + 1 + i;
-
-			Ret.push_back( &GetBirth( BirthInts[nBirth], SacrificeInts[nSacrifice1], SacrificeInts[nSacrifice2] ) );
-		}
+			for ( ; x != 0; x &= x - 1 )
+				Squares[nSquares++] = FieldSquare( row, PopCount( (x & (0u - x)) - 1 ) );
+		};
+		Append( Good | Bad, _AliveSquares, _nAlive );
+		Append( (Good & nOwnGood) | (Bad & ~Good & nOwnBad), _OwnSquares, _nOwn );
+		Append( ~(Good | Bad) & ((1u << WIDTH) - 1), _DeadSquares, _nDead );
 	}
-	return Ret;
+}
+template<typename TGeometry>
+TMoveIdentifier TMoveGenerator<TGeometry>::operator[]( size_t n ) const
+{
+	if ( n == 0 )
+		return {};
+	if ( n <= _nAlive )
+		return { { _AliveSquares[n-1], false } };
+	n -= 1 + _nAlive;
+	const size_t nBirth = n % _nDead;
+	// Pairs counted from the last one: the pairs starting at _nOwn-2-r are r(r+1)/2 to (r+1)(r+2)/2-1
+	const size_t nFromEnd = _nOwn * (_nOwn - 1) / 2 - 1 - n / _nDead;
+	size_t r = size_t( (std::sqrt( 8.0 * double( nFromEnd ) + 1.0 ) - 1.0) / 2.0 );
+	while ( r * (r + 1) / 2 > nFromEnd )
+		--r;
+	while ( (r + 1) * (r + 2) / 2 <= nFromEnd )
+		++r;
+	const size_t nSacrifice1 = _nOwn - 2 - r;
+	const size_t nSacrifice2 = _nOwn - 1 - (nFromEnd - r * (r + 1) / 2);
+	return GetBirth( nBirth, nSacrifice1, nSacrifice2 );
 }
 
 const CPass& GetPass()
@@ -91,57 +99,37 @@ const CPass& GetPass()
 	static const CPass pass;
 	return pass;
 }
+template<typename TGeometry>
 const CKill& GetKill( size_t nKill )
 {
-	const auto& AllKills = GetKills();
+	const auto& AllKills = GetKills<TGeometry>();
 	return AllKills[nKill];
 }
-const CBirth& GetBirth( size_t nBirth, size_t nSacrifice1, size_t nSacrifice2 )
+template<typename TGeometry>
+CBirth GetBirth( size_t nBirth, size_t nSacrifice1, size_t nSacrifice2 )
 {
-	const auto& AllBirths = GetBirths();
+	const auto& AllFieldSquares = GetAllFieldSquares<TGeometry>();
 	if ( nSacrifice1 == nSacrifice2 ) std::cerr << "Invalid Birth move!" << std::endl;
 	if ( nSacrifice1 > nSacrifice2 ) std::swap( nSacrifice1, nSacrifice2 );
-	return AllBirths[nBirth][nSacrifice1][nSacrifice2 - nSacrifice1 - 1];
+	return CBirth( AllFieldSquares[nBirth], AllFieldSquares[nSacrifice1], AllFieldSquares[nSacrifice2] );
 }
+template<typename TGeometry>
 const std::vector<CKill>& GetKills()
 {
 	static const std::vector<CKill> Ret = []() {
 		std::vector<CKill> kills;
-		for ( const auto& square : AllFieldSquares )
+		for ( const auto& square : GetAllFieldSquares<TGeometry>() )
 			kills.emplace_back( square );
 		return kills;
 	}();
 	return Ret;
 }
 
-const std::vector<std::vector<std::vector<CBirth>>>& GetBirths()
-{
-	static const auto CreateRet = []() {
-		std::vector<std::vector<std::vector<CBirth>>> births;
-		const size_t N = AllFieldSquares.size();
-		births.reserve( N );
-		for ( size_t nBirth = 0; nBirth < N; ++nBirth )
-		{
-			births.push_back( {} );
-			births.back().reserve( N );
-			for ( size_t nSacrifice1 = 0; nSacrifice1 < N; ++nSacrifice1 )
-			{
-				births.back().push_back( {} );
-				births.back().back().reserve( N - nSacrifice1 - 1 );
-				for ( size_t nSacrifice2 = nSacrifice1 + 1; nSacrifice2 < N; ++nSacrifice2 )
-					births.back().back().emplace_back( AllFieldSquares[nBirth], AllFieldSquares[nSacrifice1], AllFieldSquares[nSacrifice2] );
-			}
-		}
-		return births;
-	};
-	static const std::vector<std::vector<std::vector<CBirth>>> Ret = CreateRet();
-	return Ret;
-}
-
-std::vector<CBirth> GetSimilarBirths( const CBirth& Origin, const CGameField& Field )
+template<typename TGeometry>
+std::vector<CBirth> GetSimilarBirths( const CBirth& Origin, const TGameField<TGeometry>& Field )
 {
 	std::vector<CBirth> Ret;
-	for ( FieldSquare Other : AllFieldSquares )
+	for ( FieldSquare Other : GetAllFieldSquares<TGeometry>() )
 	{
 		if ( Other == Origin._target || Other == Origin._sacrifice1 || Other == Origin._sacrifice2 )
 			continue;
@@ -168,6 +156,98 @@ std::vector<CBirth> GetSimilarBirths( const CBirth& Origin, const CGameField& Fi
 	return Ret;
 }
 
+template<typename TGeometry>
+std::array<typename TGeometry::COLMASK, TGeometry::WIDTH> GetInfluence( const TGameField<TGeometry>& Field )
+{
+	constexpr int WIDTH = TGeometry::WIDTH;
+	using COLMASK = typename TGeometry::COLMASK;
+	std::array<COLMASK, WIDTH> Rows;
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		const uint32_t Alive = Field._GoodBitMask[col] | Field._BadBitMask[col];
+		Rows[col] = COLMASK( (Alive | (Alive << 1) | (Alive >> 1) | (Alive << 2) | (Alive >> 2)) & ((1u << TGeometry::HEIGHT) - 1) );
+	}
+	std::array<COLMASK, WIDTH> Ret = {};
+	for ( int col = 0; col < WIDTH; ++col )
+	{
+		for ( int c = std::max( col - 2, 0 ); c <= std::min( col + 2, WIDTH - 1 ); ++c )
+			Ret[col] |= Rows[c];
+	}
+	return Ret;
+}
+template<typename TGeometry>
+bool IsInertToggle( const TGameField<TGeometry>& Field, FieldSquare Square )
+{
+	const int row = Square.first;
+	const int col = Square.second;
+	const uint32_t Window = (0x1Fu << row) >> 2; // Rows row-2 to row+2
+	for ( int c = std::max( col - 2, 0 ); c <= std::min( col + 2, TGeometry::WIDTH - 1 ); ++c )
+	{
+		uint32_t Alive = Field._GoodBitMask[c] | Field._BadBitMask[c];
+		if ( c == col )
+			Alive &= ~(1u << row);
+		if ( Alive & Window )
+			return false;
+	}
+	return true;
+}
+bool AreIndependent( FieldSquare a, FieldSquare b )
+{
+	return std::abs( a.first - b.first ) >= 3 || std::abs( a.second - b.second ) >= 3;
+}
+
+template<typename TGeometry>
+TMoveEquivalence<TGeometry>::TMoveEquivalence( const TGameField<TGeometry>& Field, const TGameField<TGeometry>& PassField )
+	: _Field( Field ), _PassField( PassField )
+{
+	_PassEquivalent.fill( -1 );
+}
+template<typename TGeometry>
+TMoveEquivalence<TGeometry>::TMoveEquivalence( const TGameField<TGeometry>& Field, const TGameField<TGeometry>& PassField, const std::vector<TToggleDelta<TGeometry>>& Deltas )
+	: TMoveEquivalence( Field, PassField )
+{
+	for ( const TToggleDelta<TGeometry>& Delta : Deltas )
+		_PassEquivalent[ToInt<TGeometry>( Delta._Move.first )] = Delta.IsPass( PassField );
+}
+template<typename TGeometry>
+bool TMoveEquivalence<TGeometry>::IsPassEquivalent( const TMovePart& MovePart ) const
+{
+	signed char& bRet = _PassEquivalent[ToInt<TGeometry>( MovePart.first )];
+	if ( bRet == -1 )
+		bRet = IsInertToggle( _Field, MovePart.first ) || _Field.GetSuccessor( { MovePart }, _PassField ) == _PassField;
+	return bRet != 0;
+}
+template<typename TGeometry>
+TMoveIdentifier TMoveEquivalence<TGeometry>::GetClass( const TMoveIdentifier& Move ) const
+{
+	TGameField<TGeometry> Toggled = _Field;
+	for ( const TMovePart& MovePart : Move )
+		Toggled.SetSquare( MovePart.first, MovePart.second ? ELifeMode( _Field._player_to_move ) : DEAD );
+
+	// Parts are dropped one at a time, each drop keeps the successor of what is left
+	TMoveIdentifier Ret = Move;
+	for ( size_t i = 0; i < Ret.size(); )
+	{
+		const FieldSquare Square = Ret[i].first;
+		bool bDrop = IsInertToggle( Toggled, Square );
+		if ( !bDrop && IsPassEquivalent( Ret[i] ) )
+		{
+			bDrop = true; // Also if nothing else is near, then its own effect is the one it has alone
+			for ( const TMovePart& Other : Ret )
+				bDrop = bDrop && (Other.first == Square || AreIndependent( Other.first, Square ));
+		}
+		if ( !bDrop )
+		{
+			++i;
+			continue;
+		}
+		Toggled.SetSquare( Square, _Field.GetSquare( Square ) );
+		Ret.erase( i );
+	}
+	Ret.sort();
+	return Ret;
+}
+
 inline CKill::CKill( FieldSquare target ) : _target( target ) {}
 
 inline int CKill::GetIdentifierInt() const { return 1 + ToInt( _target ); }
@@ -191,4 +271,18 @@ bool operator<( const CBirth& lhs, const CBirth& rhs )
 {
 	return std::make_tuple( lhs._target, lhs._sacrifice1, lhs._sacrifice2 )
 		<  std::make_tuple( rhs._target, rhs._sacrifice1, rhs._sacrifice2 );
-}
\ No newline at end of file
+}
+
+#define INSTANTIATE_MOVE_TABLES( TGeometry ) \
+	template std::vector<TMoveIdentifier> GetValidMoves( const TGameField<TGeometry>&, int ); \
+	template const CKill& GetKill<TGeometry>( size_t ); \
+	template CBirth GetBirth<TGeometry>( size_t, size_t, size_t ); \
+	template const std::vector<CKill>& GetKills<TGeometry>(); \
+	template std::vector<CBirth> GetSimilarBirths( const CBirth&, const TGameField<TGeometry>& ); \
+	template std::array<typename TGeometry::COLMASK, TGeometry::WIDTH> GetInfluence( const TGameField<TGeometry>& ); \
+	template bool IsInertToggle( const TGameField<TGeometry>&, FieldSquare ); \
+	template class TMoveEquivalence<TGeometry>; \
+	template class TMoveGenerator<TGeometry>;
+
+INSTANTIATE_MOVE_TABLES( SSmallGeometry )
+INSTANTIATE_MOVE_TABLES( SFullGeometry )
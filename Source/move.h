@@ -48,14 +48,89 @@ public:
 
 std::string GetMoveName( const TMoveIdentifier& Move );
 
-std::vector<const CMove*> GetValidMoves(const CGameField& Field, int nSampleBirths = -1);
+// Per geometry, defined in move.cpp for SSmallGeometry and SFullGeometry. Only the kills are a table
+template<typename TGeometry>
+std::vector<TMoveIdentifier> GetValidMoves(const TGameField<TGeometry>& Field, int nSampleBirths = -1); // All of TMoveGenerator, or with nSampleBirths births (ForEachSampled)
 const CPass& GetPass();
+template<typename TGeometry = SDefaultGeometry>
 const CKill& GetKill( size_t nKill );
-const CBirth& GetBirth( size_t nBirth, size_t nSacrifice1, size_t nSacrifice2 );
+template<typename TGeometry = SDefaultGeometry>
+CBirth GetBirth( size_t nBirth, size_t nSacrifice1, size_t nSacrifice2 ); // Indices into GetAllFieldSquares, the sacrifices in either order
+template<typename TGeometry = SDefaultGeometry>
 const std::vector<CKill>& GetKills();
-const std::vector<std::vector<std::vector<CBirth>>>& GetBirths(); // GetBirth(-1)[birth][sacrifice][sacrifice]
 
-std::vector<CBirth> GetSimilarBirths( const CBirth& Origin, const CGameField& Field );
+template<typename TGeometry>
+std::vector<CBirth> GetSimilarBirths( const CBirth& Origin, const TGameField<TGeometry>& Field );
+
+// Valid moves read off the bit masks, in GetValidMoves order: pass, kills, then births by sacrifice pair and birth square.
+// Squares are numbered row by row like GetAllFieldSquares. Nothing is allocated, moves are made when asked for
+template<typename TGeometry>
+class TMoveGenerator
+{
+public:
+	explicit TMoveGenerator( const TGameField<TGeometry>& Field );
+	size_t GetKillCount() const { return _nAlive; }
+	size_t GetBirthCount() const { return _nOwn * (_nOwn - (_nOwn > 0)) / 2 * _nDead; }
+	size_t size() const { return 1 + GetKillCount() + GetBirthCount(); }
+	TMoveIdentifier operator[]( size_t n ) const; // O(1)
+
+	template<typename Functor>
+	void ForEach( const Functor& f ) const // f( TMoveIdentifier ) for every move
+	{
+		f( TMoveIdentifier() );
+		for ( size_t i = 0; i < _nAlive; ++i )
+			f( TMoveIdentifier{ { _AliveSquares[i], false } } );
+		for ( size_t nSacrifice1 = 0; nSacrifice1 < _nOwn; ++nSacrifice1 )
+			for ( size_t nSacrifice2 = nSacrifice1 + 1; nSacrifice2 < _nOwn; ++nSacrifice2 )
+				for ( size_t nBirth = 0; nBirth < _nDead; ++nBirth )
+					f( GetBirth( nBirth, nSacrifice1, nSacrifice2 ) );
+	}
+	template<typename Functor>
+	void ForEachSampled( size_t nBirths, const Functor& f ) const // Pass, every kill and nBirths births without replacement (all if fewer), in order
+	{
+		f( TMoveIdentifier() );
+		for ( size_t i = 0; i < _nAlive; ++i )
+			f( TMoveIdentifier{ { _AliveSquares[i], false } } );
+		const size_t nAllBirths = GetBirthCount();
+		SampleSequential( std::min( nBirths, nAllBirths ), nAllBirths, [this, &f]( size_t n ) { f( (*this)[1 + _nAlive + n] ); } );
+	}
+
+private:
+	TMoveIdentifier GetBirth( size_t nBirth, size_t nSacrifice1, size_t nSacrifice2 ) const
+	{
+		return { { _DeadSquares[nBirth], true }, { _OwnSquares[nSacrifice1], false }, { _OwnSquares[nSacrifice2], false } };
+	}
+	using TSquares = std::array<FieldSquare, TGeometry::WIDTH*TGeometry::HEIGHT>;
+	TSquares _AliveSquares; // Only the first _nAlive are set, and so on
+	TSquares _OwnSquares; // Squares of the player to move
+	TSquares _DeadSquares;
+	size_t _nAlive = 0;
+	size_t _nOwn = 0;
+	size_t _nDead = 0;
+};
+using CMoveGenerator = TMoveGenerator<SDefaultGeometry>;
+
+// Move equivalence. A square of the next generation only sees its 3x3 neighborhood, so a toggle can only matter through the 5x5 around it
+template<typename TGeometry>
+std::array<typename TGeometry::COLMASK, TGeometry::WIDTH> GetInfluence( const TGameField<TGeometry>& Field ); // Squares within distance 2 of a live square (5x5 dilation)
+template<typename TGeometry>
+bool IsInertToggle( const TGameField<TGeometry>& Field, FieldSquare Square ); // No other live square in the 5x5 around Square, so toggling it keeps the successor
+bool AreIndependent( FieldSquare a, FieldSquare b ); // Distance >= 3: no square of the next generation sees both
+
+template<typename TGeometry>
+class TMoveEquivalence
+{
+public:
+	TMoveEquivalence( const TGameField<TGeometry>& Field, const TGameField<TGeometry>& PassField ); // PassField = NextField( Field )
+	TMoveEquivalence( const TGameField<TGeometry>& Field, const TGameField<TGeometry>& PassField, const std::vector<TToggleDelta<TGeometry>>& Deltas ); // IsPassEquivalent read off GetSingleToggleDeltas up front
+	bool IsPassEquivalent( const TMovePart& MovePart ) const; // The successor of MovePart alone is PassField. Cached per square
+	TMoveIdentifier GetClass( const TMoveIdentifier& Move ) const; // Move without the parts that provably keep its successor, sorted. Same class, same successor; {} means pass
+private:
+	const TGameField<TGeometry>& _Field;
+	const TGameField<TGeometry>& _PassField;
+	mutable std::array<signed char, TGeometry::WIDTH*TGeometry::HEIGHT> _PassEquivalent; // -1 = not known yet
+};
+using CMoveEquivalence = TMoveEquivalence<SDefaultGeometry>;
 
 struct SBirthHash
 {
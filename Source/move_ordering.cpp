@@ -0,0 +1,89 @@
+#include "move_ordering.h"
+
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+	constexpr double KILLER_BONUS = 4.0; // Above any difference of PredictOutcome scores
+	constexpr double HISTORY_WEIGHT = 0.1; // Of the move with the most history
+}
+
+CMoveOrdering CMoveOrdering::Fork() const
+{
+	CMoveOrdering Ret = *this;
+	Ret._Stats = SMoveOrderingStats();
+	return Ret;
+}
+
+void CMoveOrdering::Merge( const CMoveOrdering& Fork )
+{
+	for ( size_t i = 0; i < _History.size(); ++i )
+		_History[i] = std::max( _History[i], Fork._History[i] );
+	_nMaxHistory = std::max( _nMaxHistory, Fork._nMaxHistory );
+	_Stats._nNodes += Fork._Stats._nNodes;
+	_Stats._nCutoffs += Fork._Stats._nCutoffs;
+	_Stats._nSearchedToCutoff += Fork._Stats._nSearchedToCutoff;
+	_Stats._nFirstCutoffs += Fork._Stats._nFirstCutoffs;
+}
+
+double CMoveOrdering::GetBonus( const TMoveIdentifier& Move, int nPly ) const
+{
+	const size_t nSlot = size_t( nPly ) % KILLER_PLIES;
+	for ( size_t i = 0; i < KILLERS_PER_PLY; ++i )
+	{
+		if ( _bKillerSet[nSlot][i] && _Killers[nSlot][i] == Move )
+			return KILLER_BONUS * (KILLERS_PER_PLY - i);
+	}
+	if ( _nMaxHistory == 0 )
+		return 0.0;
+	uint32_t nHistory = _History[0];
+	if ( !Move.empty() )
+	{
+		nHistory = 0;
+		for ( size_t i = 0; i < Move.size(); ++i )
+			nHistory = std::max( nHistory, _History[Move.GetPartCode( i )] );
+	}
+	return HISTORY_WEIGHT * nHistory / _nMaxHistory;
+}
+
+void CMoveOrdering::NotifyCutoff( const TMoveIdentifier& Move, int nPly, int nDepthLeft, size_t nSearched )
+{
+	++_Stats._nCutoffs;
+	_Stats._nSearchedToCutoff += nSearched;
+	_Stats._nFirstCutoffs += nSearched == 1;
+
+	const size_t nSlot = size_t( nPly ) % KILLER_PLIES;
+	if ( !(_bKillerSet[nSlot][0] && _Killers[nSlot][0] == Move) )
+	{
+		for ( size_t i = KILLERS_PER_PLY - 1; i > 0; --i )
+		{
+			_Killers[nSlot][i] = _Killers[nSlot][i-1];
+			_bKillerSet[nSlot][i] = _bKillerSet[nSlot][i-1];
+		}
+		_Killers[nSlot][0] = Move;
+		_bKillerSet[nSlot][0] = true;
+	}
+
+	const uint32_t nBonus = uint32_t( nDepthLeft * nDepthLeft );
+	auto Add = [this, nBonus]( uint32_t nCode )
+	{
+		_History[nCode] += nBonus;
+		_nMaxHistory = std::max( _nMaxHistory, _History[nCode] );
+	};
+	if ( Move.empty() )
+		Add( 0 );
+	for ( size_t i = 0; i < Move.size(); ++i )
+		Add( Move.GetPartCode( i ) );
+}
+
+void CMoveOrdering::PrintStats( std::ostream& output ) const
+{
+	output << "Move ordering: " << _Stats._nNodes << " searched, " << _Stats._nCutoffs << " cutoffs";
+	if ( _Stats._nCutoffs > 0 )
+	{
+		output << ", " << double( _Stats._nSearchedToCutoff ) / _Stats._nCutoffs << " searched per cutoff, "
+			<< 100.0 * _Stats._nFirstCutoffs / _Stats._nCutoffs << "% on the first";
+	}
+	output << std::endl;
+}
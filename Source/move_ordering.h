@@ -0,0 +1,40 @@
+#pragma once
+
+#include "util.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// History and killer moves for DoDeepSearch, one table per root search. A move that cut off the search at one node is tried early
+// at its siblings (killers, by ply) and anywhere later (history, by move part square and type)
+constexpr size_t KILLER_PLIES = 32; // Plies are taken modulo this
+constexpr size_t KILLERS_PER_PLY = 2;
+
+struct SMoveOrderingStats
+{
+	size_t _nNodes = 0; // Candidates searched
+	size_t _nCutoffs = 0;
+	size_t _nSearchedToCutoff = 0; // Candidates searched at the cutoff nodes, the one that cut off included
+	size_t _nFirstCutoffs = 0; // The first candidate cut off
+};
+
+class CMoveOrdering
+{
+public:
+	CMoveOrdering Fork() const; // Same tables, no stats yet: for a subtree searched on another thread
+	void Merge( const CMoveOrdering& Fork ); // Its stats add up, history keeps the larger count, killers stay ours
+	double GetBonus( const TMoveIdentifier& Move, int nPly ) const; // Added to the static score: killers come first, then history tips the order a little
+	void NotifySearched() { ++_Stats._nNodes; }
+	void NotifyCutoff( const TMoveIdentifier& Move, int nPly, int nDepthLeft, size_t nSearched ); // nSearched counts Move
+
+	const SMoveOrderingStats& GetStats() const { return _Stats; }
+	void PrintStats( std::ostream& output ) const;
+private:
+	std::array<uint32_t, SPackedMove::PART_CODES> _History = {}; // Code 0 is pass
+	uint32_t _nMaxHistory = 0;
+	std::array<std::array<TMoveIdentifier, KILLERS_PER_PLY>, KILLER_PLIES> _Killers = {};
+	std::array<std::array<bool, KILLERS_PER_PLY>, KILLER_PLIES> _bKillerSet = {};
+	SMoveOrderingStats _Stats;
+};
@@ -16,6 +16,7 @@ public:
 	void LearnFrom( const CGame& Game, double vLearnRate, NetworkType* pUpdateToMe ) const;
 
 	double PredictOutcome( const CGameField& Field, int nPlayer ) const override;
+	int GetHorizon() const override { return 1 + NetworkType::LOOKAHEAD; } // The successor, then the generations its input steps
 
 	NetworkType _Layers;
 	constexpr static size_t N_LAYERS = decltype(_Layers)::_N;
@@ -57,8 +58,7 @@ void CNNBot<NetworkType>::LearnFrom( const CGame& Game, double vLearnRate, Netwo
 	for ( int i = int( Game.size() - 1 ); i >= 0 && vLearnRate > 0.0; --i )
 	{
 		const CGameField& Field = Game._FieldsAndMoves[i].first;
-		for ( const CGameField& Mirror : GetSymmetries( Field ) )
-			LearnFrom( Mirror, vLearnRate, vWinner, pUpdateToMe );
+		ForEachSymmetry( Field, [&]( const CGameField& Mirror ) { LearnFrom( Mirror, vLearnRate, vWinner, pUpdateToMe ); } );
 		const double vError = LearnFrom( Field, vLearnRate, vWinner, pUpdateToMe ); // Learn from Field twice
 		vLearnRate *= 1.0 - abs( vError )/2;
 	}
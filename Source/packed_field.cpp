@@ -0,0 +1,167 @@
+#include "packed_field.h"
+
+namespace
+{
+	using TBits = SPackedField::TBits;
+	constexpr int WORDS = SPackedField::WORDS;
+
+	TBits MakeMask( bool bSkipFirstCol, bool bSkipLastCol )
+	{
+		TBits Ret = {};
+		for ( int row = 0; row < HEIGHT; ++row ) for ( int col = 0; col < WIDTH; ++col )
+		{
+			if ( (bSkipFirstCol && col == 0) || (bSkipLastCol && col == WIDTH-1) )
+				continue;
+			const int i = row*WIDTH + col;
+			Ret[i/64] |= uint64_t( 1 ) << (i%64);
+		}
+		return Ret;
+	}
+	const TBits NotFirstCol = MakeMask( true, false );
+	const TBits NotLastCol = MakeMask( false, true );
+	const TBits OnBoard = MakeMask( false, false );
+
+	template<int D> // Bit i of the result is bit i+D of X
+	inline TBits ShiftDown( const TBits& X )
+	{
+		static_assert(D > 0 && D < 64, "");
+		TBits Ret;
+		for ( int w = 0; w < WORDS-1; ++w )
+			Ret[w] = (X[w] >> D) | (X[w+1] << (64-D));
+		Ret[WORDS-1] = X[WORDS-1] >> D;
+		return Ret;
+	}
+	template<int D> // Bit i of the result is bit i-D of X
+	inline TBits ShiftUp( const TBits& X )
+	{
+		static_assert(D > 0 && D < 64, "");
+		TBits Ret;
+		for ( int w = WORDS-1; w > 0; --w )
+			Ret[w] = (X[w] << D) | (X[w-1] >> (64-D));
+		Ret[0] = X[0] << D;
+		return Ret;
+	}
+	inline TBits And( const TBits& A, const TBits& B )
+	{
+		TBits Ret;
+		for ( int w = 0; w < WORDS; ++w )
+			Ret[w] = A[w] & B[w];
+		return Ret;
+	}
+
+	std::array<TBits, 8> GetNeighbors( const TBits& X )
+	{
+		// Neighbors from the column to the left may not wrap around from the last column, and vice versa
+		const TBits FromLeft = And( X, NotLastCol );
+		const TBits FromRight = And( X, NotFirstCol );
+		return {
+			ShiftUp<WIDTH>( X ),
+			ShiftDown<WIDTH>( X ),
+			ShiftUp<1>( FromLeft ),
+			ShiftUp<WIDTH+1>( FromLeft ),
+			ShiftDown<WIDTH-1>( FromLeft ),
+			ShiftDown<1>( FromRight ),
+			ShiftDown<WIDTH+1>( FromRight ),
+			ShiftUp<WIDTH-1>( FromRight ),
+		};
+	}
+}
+
+SPackedField ToPacked( const CGameField& Field )
+{
+	SPackedField Ret;
+	for ( int col = 0; col < WIDTH; ++col ) for ( int row = 0; row < HEIGHT; ++row )
+	{
+		const int i = row*WIDTH + col;
+		if ( (Field._GoodBitMask[col] >> row) & 1 )
+			Ret._Good[i/64] |= uint64_t( 1 ) << (i%64);
+		if ( (Field._BadBitMask[col] >> row) & 1 )
+			Ret._Bad[i/64] |= uint64_t( 1 ) << (i%64);
+	}
+	Ret._winner = Field._winner;
+	Ret._player_to_move = Field._player_to_move;
+	Ret._time = Field._time;
+	Ret._last_killed = Field._last_killed;
+	return Ret;
+}
+
+CGameField FromPacked( const SPackedField& Packed )
+{
+	CGameField Ret;
+	for ( int col = 0; col < WIDTH; ++col ) for ( int row = 0; row < HEIGHT; ++row )
+	{
+		const int i = row*WIDTH + col;
+		if ( (Packed._Good[i/64] >> (i%64)) & 1 )
+			Ret._GoodBitMask[col] |= COLMASK( 1 << row );
+		if ( (Packed._Bad[i/64] >> (i%64)) & 1 )
+			Ret._BadBitMask[col] |= COLMASK( 1 << row );
+	}
+	Ret._winner = Packed._winner;
+	Ret._player_to_move = Packed._player_to_move;
+	Ret._time = Packed._time;
+	Ret._last_killed = Packed._last_killed;
+	Ret.UpdateHash();
+	Ret.UpdateCounts();
+	return Ret;
+}
+
+SPackedField NextPacked( const SPackedField& Field )
+{
+	TBits Alive;
+	for ( int w = 0; w < WORDS; ++w )
+		Alive[w] = Field._Good[w] | Field._Bad[w];
+
+	TBits TooManyNeighbors = {};
+	TBits EnoughNeighbors = {};
+	{
+		TBits Sum1 = {};
+		TBits Sum2 = {};
+		for ( const TBits& x : GetNeighbors( Alive ) )
+		{
+			for ( int w = 0; w < WORDS; ++w )
+			{
+				TooManyNeighbors[w] |= Sum1[w] & Sum2[w] & x[w]; // 1 + 2 + 1 -> Too Large
+				Sum2[w] ^= Sum1[w] & x[w];
+				Sum1[w] ^= x[w];
+				EnoughNeighbors[w] |= Sum2[w] & (Sum1[w] | Alive[w]); // 2 + (Self or 1)
+			}
+		}
+	}
+	TBits GoodDominates = {}; // If at least 2 good neighbors
+	{
+		TBits Good1 = {};
+		for ( const TBits& x : GetNeighbors( Field._Good ) )
+		{
+			for ( int w = 0; w < WORDS; ++w )
+			{
+				GoodDominates[w] |= Good1[w] & x[w];
+				Good1[w] ^= x[w];
+			}
+		}
+	}
+
+	SPackedField Ret;
+	uint64_t AnyGood = 0;
+	uint64_t AnyBad = 0;
+	for ( int w = 0; w < WORDS; ++w )
+	{
+		const uint64_t Survivors = EnoughNeighbors[w] & ~TooManyNeighbors[w] & OnBoard[w];
+		Ret._Good[w] = Survivors & ~Field._Bad[w] & (GoodDominates[w] | Alive[w]);
+		Ret._Bad[w] = Survivors & ~Field._Good[w] & (~GoodDominates[w] | Alive[w]);
+		AnyGood |= Ret._Good[w];
+		AnyBad |= Ret._Bad[w];
+	}
+
+	Ret._time = Field._time + 1;
+	Ret._player_to_move = -Field._player_to_move;
+	{
+		// Win conditions
+		if ( !AnyBad && AnyGood )
+			Ret._winner = CGameField::POSITIVE;
+		else if ( !AnyGood && AnyBad )
+			Ret._winner = CGameField::NEGATIVE;
+		else if ( !AnyBad || Ret._time >= MAX_ROUNDS )
+			Ret._winner = CGameField::DRAW;
+	}
+	return Ret;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "game_field.h"
+#include "settings.h"
+
+#include <array>
+#include <cstdint>
+
+// Row-packed alternative to CGameField: Cell (row, col) is bit row*WIDTH+col of a multi-word register per colour.
+// Stepping shifts whole registers instead of gathering neighbors column by column. Not over-aligned, so it can live in a std::vector before C++17
+struct SPackedField
+{
+	constexpr static int BITS = WIDTH*HEIGHT;
+	constexpr static int WORDS = (BITS + 63) / 64; // 5 for the full field
+	using TBits = std::array<uint64_t, WORDS>;
+
+	TBits _Good = {};
+	TBits _Bad = {};
+
+	CGameField::EResult _winner = CGameField::UNDETERMINED;
+	signed char _player_to_move = 1;
+	short _time = 0;
+	ELifeMode _last_killed = DEAD;
+};
+
+SPackedField ToPacked( const CGameField& Field );
+CGameField FromPacked( const SPackedField& Packed );
+
+SPackedField NextPacked( const SPackedField& Field );
@@ -0,0 +1,136 @@
+#include "rollout.h"
+#include "util.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr int MAX_SAMPLED_BIRTHS = 200; // As CRandomBot asks GetValidMoves for
+
+	uint64_t SplitMix( uint64_t x )
+	{
+		x += 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+	struct SLaneRandom // xorshift64*, 8 bytes per game instead of sharing SafeRand and its mutex
+	{
+		explicit SLaneRandom( uint64_t nSeed ) : _nState( SplitMix( nSeed ) | 1 ) {}
+		uint32_t operator()()
+		{
+			_nState ^= _nState >> 12;
+			_nState ^= _nState << 25;
+			_nState ^= _nState >> 27;
+			return uint32_t( (_nState * 0x2545F4914F6CDD1Dull) >> 32 );
+		}
+		uint32_t Below( uint32_t n ) { return uint32_t( (uint64_t( (*this)() ) * n) >> 32 ); }
+		uint64_t _nState;
+	};
+
+	FieldSquare GetNthSquare( const std::array<COLMASK, WIDTH>& Mask, int n ) // n-th set bit, column by column
+	{
+		for ( int col = 0; col < WIDTH; ++col )
+		{
+			const int nCount = PopCount( Mask[col] );
+			if ( n >= nCount )
+			{
+				n -= nCount;
+				continue;
+			}
+			uint32_t x = Mask[col];
+			for ( ; n > 0; --n )
+				x &= x - 1;
+			return FieldSquare( PopCount( (x & (0u - x)) - 1 ), col );
+		}
+		return FieldSquare( 0, 0 );
+	}
+
+	void MakeRandomMove( CGameField& Field, SLaneRandom& Random ) // Only the toggles, the caller steps
+	{
+		std::array<COLMASK, WIDTH> Alive, Own, Dead;
+		for ( int col = 0; col < WIDTH; ++col )
+		{
+			Alive[col] = Field._GoodBitMask[col] | Field._BadBitMask[col];
+			Own[col] = Field._player_to_move == 1 ? Field._GoodBitMask[col] : Field._BadBitMask[col];
+			Dead[col] = COLMASK( ~Alive[col] & ((1u << HEIGHT) - 1) );
+		}
+		const int nAlive = Field._nGood + Field._nBad;
+		const int nOwn = Field._player_to_move == 1 ? Field._nGood : Field._nBad;
+		const int nDead = WIDTH*HEIGHT - nAlive;
+		const int nBirths = nOwn < 2 ? 0 : int( std::min<long long>( MAX_SAMPLED_BIRTHS, (long long)( nOwn*(nOwn-1)/2 ) * nDead ) );
+
+		const int nMove = int( Random.Below( uint32_t( 1 + nAlive + nBirths ) ) );
+		if ( nMove == 0 )
+			return; // Pass
+		if ( nMove <= nAlive )
+		{
+			Field.SetSquare( GetNthSquare( Alive, nMove - 1 ), DEAD );
+			return;
+		}
+		const int nSacrifice1 = int( Random.Below( nOwn ) );
+		const int nSacrifice2 = (nSacrifice1 + 1 + int( Random.Below( nOwn - 1 ) )) % nOwn;
+		Field.SetSquare( GetNthSquare( Dead, int( Random.Below( nDead ) ) ), ELifeMode( Field._player_to_move ) );
+		Field.SetSquare( GetNthSquare( Own, nSacrifice1 ), DEAD );
+		Field.SetSquare( GetNthSquare( Own, nSacrifice2 ), DEAD );
+	}
+}
+
+double SRolloutStats::GetScore( int nPlayer ) const
+{
+	if ( GetGames() == 0 )
+		return 0.0;
+	return nPlayer * double( _nWins - _nLosses ) / GetGames();
+}
+
+SRolloutStats Rollout( const CGameField& Field, int nGames, uint64_t nSeed )
+{
+	return Rollout( std::vector<CGameField>( 1, Field ), nGames, nSeed )[0];
+}
+std::vector<SRolloutStats> Rollout( const std::vector<CGameField>& Fields, int nGamesPerField, uint64_t nSeed )
+{
+	std::vector<SRolloutStats> Ret( Fields.size() );
+	const size_t N = Fields.size() * nGamesPerField;
+	std::vector<CGameField> Boards;
+	std::vector<size_t> Origins; // Index into Fields
+	std::vector<SLaneRandom> Randoms;
+	Boards.reserve( N );
+	Origins.reserve( N );
+	Randoms.reserve( N );
+	for ( size_t i = 0; i < N; ++i )
+	{
+		Boards.push_back( Fields[i / nGamesPerField] );
+		Origins.push_back( i / nGamesPerField );
+		Randoms.emplace_back( nSeed + i );
+	}
+
+	size_t nActive = N;
+	while ( nActive > 0 )
+	{
+		// Finished games leave, the last running game takes their place
+		for ( size_t i = 0; i < nActive; )
+		{
+			const CGameField::EResult Winner = Boards[i]._winner;
+			if ( Winner == CGameField::UNDETERMINED )
+			{
+				++i;
+				continue;
+			}
+			SRolloutStats& Stats = Ret[Origins[i]];
+			++(Winner == CGameField::POSITIVE ? Stats._nWins : Winner == CGameField::NEGATIVE ? Stats._nLosses : Stats._nDraws);
+			--nActive;
+			std::swap( Boards[i], Boards[nActive] );
+			std::swap( Origins[i], Origins[nActive] );
+			std::swap( Randoms[i], Randoms[nActive] );
+		}
+		for ( size_t i = 0; i < nActive; ++i )
+			MakeRandomMove( Boards[i], Randoms[i] );
+		NextFieldBatch( Boards.data(), Boards.data(), nActive );
+	}
+	return Ret;
+}
+
+double CRolloutBot::PredictOutcome( const CGameField& Field, int nPlayer ) const
+{
+	return Rollout( Field, _nGames, Field.GetHash() ).GetScore( nPlayer );
+}
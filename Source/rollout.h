@@ -0,0 +1,31 @@
+#pragma once
+
+#include "bot.h"
+#include "game_field.h"
+
+#include <vector>
+#include <cstdint>
+
+// Monte-Carlo evaluation: random games from a field to the end, all games stepped together by NextFieldBatch.
+// Moves are drawn like CRandomBot: pass, any kill or one of up to 200 births, each equally likely
+struct SRolloutStats
+{
+	int _nWins = 0; // Won by player 1 (POSITIVE)
+	int _nDraws = 0;
+	int _nLosses = 0;
+	int GetGames() const { return _nWins + _nDraws + _nLosses; }
+	double GetScore( int nPlayer ) const; // Mean outcome for nPlayer, in [-1,1]
+};
+
+SRolloutStats Rollout( const CGameField& Field, int nGames, uint64_t nSeed );
+std::vector<SRolloutStats> Rollout( const std::vector<CGameField>& Fields, int nGamesPerField, uint64_t nSeed ); // All games of all fields in lock-step
+
+class CRolloutBot : public CHeuristicBot
+{
+public:
+	CRolloutBot( int nGames, int nSampleBirths = -1 ) : CHeuristicBot( nSampleBirths ), _nGames( nGames ) {}
+	double PredictOutcome( const CGameField& Field, int nPlayer ) const override; // Seeded by the field hash, so repeatable
+	bool IsDeterministic() const override { return false; } // Rollouts play on to MAX_ROUNDS, so every move depends on _time
+
+	int _nGames;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <cstdint>
 
 #define TESTING
 
@@ -16,24 +17,42 @@ constexpr int THREADS = 12;
 //#define SMALL_FIELD
 #endif
 
+//#define LOOKUP_KERNEL // NextField defaults to NextFieldLookup instead of NextFieldSuperFast
+//#define CLUSTER_LOOKAHEAD // NextFieldN takes recurring small clusters from a memo of their evolution (cluster.h)
+//#define BENCHMARK // main only runs the kernel benchmarks and the Conway fuzzer (benchmark.h)
+//#define AUTOTUNE_KERNELS // main times the kernel variants for this CPU at startup and keeps the fastest (cpu_dispatch.h)
+
+template<int W, int H, typename TColMask, int LIVES>
+struct SGeometry
+{
+	static_assert( H <= 8 * int( sizeof( TColMask ) ), "A column has to fit in COLMASK" );
+	static constexpr int WIDTH = W;
+	static constexpr int HEIGHT = H;
+	using COLMASK = TColMask;
+	static constexpr int START_LIVES = LIVES;
+};
+template<int W, int H, typename TColMask, int LIVES> constexpr int SGeometry<W, H, TColMask, LIVES>::WIDTH;
+template<int W, int H, typename TColMask, int LIVES> constexpr int SGeometry<W, H, TColMask, LIVES>::HEIGHT;
+template<int W, int H, typename TColMask, int LIVES> constexpr int SGeometry<W, H, TColMask, LIVES>::START_LIVES;
+
 namespace Settings
 {
 	constexpr int TIMEBANK = 10000;
 	constexpr int TIME_PER_MOVE = 100;
 	constexpr int MAX_ROUNDS = 200;
-#ifdef SMALL_FIELD
-	constexpr int WIDTH = 10;
-	constexpr int HEIGHT = 8;
-	using COLMASK = uint8_t;
 
-	constexpr int START_LIVES = 18;
+	using SSmallGeometry = SGeometry<10, 8, uint8_t, 18>;
+	using SFullGeometry = SGeometry<18, 16, uint16_t, 40>;
+#ifdef SMALL_FIELD
+	using SDefaultGeometry = SSmallGeometry;
 #else
-	constexpr int WIDTH = 18;
-	constexpr int HEIGHT = 16;
-	using COLMASK = uint16_t;
-
-	constexpr int START_LIVES = 40;
+	using SDefaultGeometry = SFullGeometry;
 #endif
+	// The geometry of CGameField, bots and games. TGameField<TGeometry> shadows these with its own
+	constexpr int WIDTH = SDefaultGeometry::WIDTH;
+	constexpr int HEIGHT = SDefaultGeometry::HEIGHT;
+	using COLMASK = SDefaultGeometry::COLMASK;
+	constexpr int START_LIVES = SDefaultGeometry::START_LIVES;
 
 	static const std::string DATA_DIR = "../saved_data/";
 }
@@ -0,0 +1,21 @@
+#include "successor_scores.h"
+
+#include <iostream>
+
+void SSuccessorDedupStats::Add( const SSuccessorDedupStats& Other )
+{
+	for ( int i = 0; i < DEDUP_SITES; ++i )
+	{
+		_nLookups[i] += Other._nLookups[i];
+		_nHits[i] += Other._nHits[i];
+	}
+}
+
+void PrintSuccessorDedupStats( std::ostream& output, const SSuccessorDedupStats& Stats )
+{
+	static const char* Names[DEDUP_SITES] = { "division", "combinations", "deep search" };
+	output << "Successor dedup hits:";
+	for ( int i = 0; i < DEDUP_SITES; ++i )
+		output << " " << Names[i] << " " << Stats._nHits[i] << "/" << Stats._nLookups[i];
+	output << std::endl;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Different moves often lead to the same board. One search node keeps the successors it has seen by GetHash, so each is scored and searched once
+enum ESuccessorDedupSite
+{
+	DEDUP_DIVISION, // Single toggles scored by CreateDivision and CreateDivisionFast
+	DEDUP_COMBINATIONS, // Triples scored by ProposeMovesFromDivision
+	DEDUP_DEEP_SEARCH, // Candidates searched by DoDeepSearch
+	DEDUP_SITES
+};
+struct SSuccessorDedupStats // Of one root search
+{
+	std::array<size_t, DEDUP_SITES> _nLookups = {};
+	std::array<size_t, DEDUP_SITES> _nHits = {};
+	void Add( const SSuccessorDedupStats& Other );
+};
+void PrintSuccessorDedupStats( std::ostream& output, const SSuccessorDedupStats& Stats ); // Hit rate per site
+class CSuccessorScores
+{
+public:
+	CSuccessorScores( ESuccessorDedupSite Site, SSuccessorDedupStats& Stats ) : _Site( Site ), _Stats( Stats ) {}
+	template<typename Functor>
+	double GetScore( uint64_t nHash, const Functor& Score ) // Score() the first time nHash is seen
+	{
+		const auto Inserted = _Scores.emplace( nHash, 0.0 );
+		Count( !Inserted.second );
+		if ( Inserted.second )
+			Inserted.first->second = Score();
+		return Inserted.first->second;
+	}
+	bool Insert( uint64_t nHash ) // false if seen before
+	{
+		const bool bNew = _Scores.emplace( nHash, 0.0 ).second;
+		Count( !bNew );
+		return bNew;
+	}
+private:
+	void Count( bool bHit )
+	{
+		++_Stats._nLookups[_Site];
+		_Stats._nHits[_Site] += bHit;
+	}
+	std::unordered_map<uint64_t, double> _Scores;
+	ESuccessorDedupSite _Site;
+	SSuccessorDedupStats& _Stats;
+};
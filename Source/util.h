@@ -4,11 +4,21 @@
 
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
 #include <thread>
 #include <set>
 #include <future>
 #include <chrono>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 template<typename T>
 constexpr T square( T x )
 {
@@ -21,8 +31,81 @@ constexpr T cube( T x )
 }
 
 using FieldSquare = std::pair<unsigned char, unsigned char>;
-using TMovePart = std::pair<FieldSquare, bool>;
-using TMoveIdentifier = std::vector<TMovePart>;
+using TMovePart = std::pair<FieldSquare, bool>; // true = birth, false = kill
+using TMoveVector = std::vector<TMovePart>; // Unpacked move, for streams and the protocol
+
+// A move in 32 bits: pass, kill, or birth with its two sacrifices. Trivially copyable, and ordered like its TMoveVector.
+// Part i is 10 bits from bit 20-10i down: 1 + row*64 + col*2 + birth, 0 if there are fewer parts. Rows below 16, columns below 31
+struct SPackedMove
+{
+	static constexpr size_t MAX_PARTS = 3;
+	class const_iterator // Yields TMovePart by value
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = TMovePart;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const TMovePart*;
+		using reference = TMovePart;
+		explicit const_iterator( uint32_t nBits ) : _nBits( nBits ) {}
+		TMovePart operator*() const { return Unpack( _nBits >> 20 ); }
+		const_iterator& operator++() { _nBits = (_nBits << 10) & PARTS_MASK; return *this; }
+		bool operator==( const const_iterator& O ) const { return _nBits == O._nBits; }
+		bool operator!=( const const_iterator& O ) const { return _nBits != O._nBits; }
+	private:
+		uint32_t _nBits; // The part at the top is the current one, 0 at the end
+	};
+
+	SPackedMove() = default;
+	SPackedMove( std::initializer_list<TMovePart> Parts ) { for ( const TMovePart& Part : Parts ) push_back( Part ); }
+	explicit SPackedMove( const TMoveVector& Parts ) { for ( const TMovePart& Part : Parts ) push_back( Part ); }
+	TMoveVector ToVector() const { return TMoveVector( begin(), end() ); }
+
+	size_t size() const { return _nBits == 0 ? 0 : (_nBits & 0x3FF) ? 3 : (_nBits & 0xFFC00) ? 2 : 1; }
+	bool empty() const { return _nBits == 0; }
+	TMovePart operator[]( size_t i ) const { return Unpack( GetPartCode( i ) ); }
+	uint32_t GetPartCode( size_t i ) const { return (_nBits >> (20 - 10*i)) & 0x3FF; } // Pack( (*this)[i] ), below PART_CODES
+	const_iterator begin() const { return const_iterator( _nBits ); }
+	const_iterator end() const { return const_iterator( 0 ); }
+	void push_back( const TMovePart& Part ) { _nBits |= Pack( Part ) << (20 - 10*size()); } // At most MAX_PARTS
+	void erase( size_t i ) // Later parts move up
+	{
+		const uint32_t nKeep = ~0u << (30 - 10*i); // Parts before i
+		_nBits = (_nBits & nKeep & PARTS_MASK) | ((_nBits << 10) & ~nKeep & PARTS_MASK);
+	}
+	void sort() // Parts in ascending order, like std::sort on the TMoveVector
+	{
+		std::array<uint32_t, MAX_PARTS> Parts = { _nBits >> 20, (_nBits >> 10) & 0x3FF, _nBits & 0x3FF };
+		const size_t N = size();
+		std::sort( Parts.begin(), Parts.begin() + N );
+		_nBits = 0;
+		for ( size_t i = 0; i < N; ++i )
+			_nBits |= Parts[i] << (20 - 10*i);
+	}
+
+	bool operator==( const SPackedMove& O ) const { return _nBits == O._nBits; }
+	bool operator!=( const SPackedMove& O ) const { return _nBits != O._nBits; }
+	bool operator<( const SPackedMove& O ) const { return _nBits < O._nBits; }
+
+	static constexpr uint32_t PARTS_MASK = (1u << 30) - 1;
+	static constexpr size_t PART_CODES = 1 << 10;
+	static uint32_t Pack( const TMovePart& Part ) { return 1 + Part.first.first * 64u + Part.first.second * 2u + (Part.second ? 1u : 0u); }
+	static TMovePart Unpack( uint32_t n ) { --n; return TMovePart( FieldSquare( (unsigned char)( n >> 6 ), (unsigned char)( (n >> 1) & 31 ) ), (n & 1) != 0 ); }
+
+	uint32_t _nBits = 0;
+};
+struct SPackedMoveHasher
+{
+	size_t operator()( const SPackedMove& Move ) const
+	{
+		return size_t( (uint64_t( Move._nBits ) * 0x9E3779B97F4A7C15ull) >> 32 );
+	}
+};
+using TMoveIdentifier = SPackedMove;
+
+template<typename TGeometry>
+class TGameField;
+using CGameField = TGameField<SDefaultGeometry>;
 
 template<typename Functor, typename... Args>
 auto RunThreaded( const Functor& func, const Args&... args )
@@ -42,6 +125,15 @@ auto RunThreaded( const Functor& func, const Args&... args )
 
 unsigned int SafeRand();
 
+inline int PopCount( uint32_t x )
+{
+#ifdef _MSC_VER
+	return int( __popcnt( x ) );
+#else
+	return __builtin_popcount( x );
+#endif
+}
+
 template<typename T>
 void KnuthShuffle( T& V )
 {
@@ -54,6 +146,98 @@ void KnuthShuffle( T& V )
 	}
 }
 
+inline double SafeRandUniform() // In (0,1)
+{
+	return (double( SafeRand() ) + 0.5) / 4294967296.0;
+}
+// f( i ) for n of the indices 0 to N-1, each n-subset equally likely, in increasing order. Vitter's method D: O(n) expected time, no storage
+template<typename Functor>
+void SampleSequential( size_t n, size_t N, const Functor& f )
+{
+	if ( n == 0 )
+		return;
+	constexpr double ALPHA_INV = 13.0; // Method A is faster while N < ALPHA_INV * n
+	size_t nIndex = 0;
+	double vPrime = std::exp( std::log( SafeRandUniform() ) / double( n ) );
+	size_t nQu1 = N - n + 1;
+	while ( n > 1 && ALPHA_INV * double( n ) < double( N ) )
+	{
+		const double vN = double( N ), vn = double( n );
+		const double vNMin1Inv = 1.0 / (vn - 1.0);
+		size_t S;
+		for ( ;; )
+		{
+			double X;
+			for ( ;; ) // Step D2: S from the continuous approximation
+			{
+				X = vN * (1.0 - vPrime);
+				S = size_t( X );
+				if ( S < nQu1 )
+					break;
+				vPrime = std::exp( std::log( SafeRandUniform() ) / vn );
+			}
+			const double vU = SafeRandUniform();
+			const double y1 = std::exp( std::log( vU * vN / double( nQu1 ) ) * vNMin1Inv );
+			vPrime = y1 * (1.0 - X / vN) * (double( nQu1 ) / (double( nQu1 ) - double( S )));
+			if ( vPrime <= 1.0 )
+				break; // Step D3: quick accept
+			double y2 = 1.0; // Step D4: exact test
+			double vTop = vN - 1.0;
+			double vBottom;
+			size_t nLimit;
+			if ( n - 1 > S )
+			{
+				vBottom = vN - vn;
+				nLimit = N - S;
+			}
+			else
+			{
+				vBottom = vN - double( S ) - 1.0;
+				nLimit = nQu1;
+			}
+			for ( size_t t = N - 1; t >= nLimit; --t )
+			{
+				y2 = (y2 * vTop) / vBottom;
+				vTop -= 1.0;
+				vBottom -= 1.0;
+			}
+			if ( vN / (vN - X) >= y1 * std::exp( std::log( y2 ) * vNMin1Inv ) )
+			{
+				vPrime = std::exp( std::log( SafeRandUniform() ) * vNMin1Inv );
+				break;
+			}
+			vPrime = std::exp( std::log( SafeRandUniform() ) / vn );
+		}
+		nIndex += S;
+		f( nIndex++ );
+		N -= S + 1;
+		--n;
+		nQu1 -= S;
+	}
+	if ( n == 1 ) // vPrime is still a fresh U^(1/n)
+	{
+		f( nIndex + size_t( double( N ) * vPrime ) );
+		return;
+	}
+	// Method A: skip over each index with its exact probability
+	double vTop = double( N - n ), vN = double( N );
+	for ( ; n >= 2; --n )
+	{
+		const double vV = SafeRandUniform();
+		double vQuot = vTop / vN;
+		while ( vQuot > vV )
+		{
+			++nIndex;
+			vTop -= 1.0;
+			vN -= 1.0;
+			vQuot = (vQuot * vTop) / vN;
+		}
+		f( nIndex++ );
+		vN -= 1.0;
+	}
+	f( nIndex + size_t( vN * SafeRandUniform() ) );
+}
+
 template<typename TData, typename NumericType = double>
 class CCandidateList
 {